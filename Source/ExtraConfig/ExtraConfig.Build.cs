@@ -40,6 +40,9 @@ public class ExtraConfig : ModuleRules
 				"Engine",
 				"InputCore",
 				"RHI",
+				"RenderCore",
+				"Slate",
+				"SlateCore",
 				// ... add private dependencies that you statically link with here ...	
 			}
 			);
@@ -0,0 +1,176 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ExtraConfigPrivatePCH.h"
+#include "AnalogConfigIndex.h"
+
+int32 FAnalogConfigIndex::SettingsGeneration = 0;
+
+FAnalogConfigIndex::FAnalogConfigIndex()
+	: BuiltGeneration(0)
+	, NumEntries(0)
+	, NumDuplicates(0)
+	, bBuilt(false)
+{
+}
+
+FAnalogConfigIndex& FAnalogConfigIndex::Get(UInputSettings* settings)
+{
+	static FAnalogConfigIndex Instance;
+
+	//the count is only a backstop for code outside the plugin that edits AxisConfig unannounced
+	if (!Instance.bBuilt || Instance.BuiltGeneration != SettingsGeneration || Instance.NumEntries != settings->AxisConfig.Num())
+	{
+		Instance.Build(settings);
+	}
+
+	return Instance;
+}
+
+void FAnalogConfigIndex::MarkSettingsChanged()
+{
+	SettingsGeneration++;
+}
+
+int32 FAnalogConfigIndex::Compact(TArray<FInputAxisConfigEntry>& entries)
+{
+	TSet<FName> seen;
+	int32 removed = 0;
+
+	//walk backwards so the last entry for a key is the one kept
+	for (int32 i = entries.Num() - 1; i >= 0; i--)
+	{
+		bool bAlreadySeen = false;
+		seen.Add(entries[i].AxisKeyName, &bAlreadySeen);
+
+		if (bAlreadySeen)
+		{
+			entries.RemoveAt(i);
+			removed++;
+		}
+	}
+
+	return removed;
+}
+
+int32 FAnalogConfigIndex::CompactSettings(UInputSettings* settings)
+{
+	int32 removed = Compact(settings->AxisConfig);
+	if (removed > 0)
+	{
+		UE_LOG(LogExtraConfig, Log, TEXT("Removed %d duplicate AxisConfig entries"), removed);
+		MarkSettingsChanged();
+	}
+
+	return removed;
+}
+
+void FAnalogConfigIndex::Build(const UInputSettings* settings)
+{
+	IndexByKey.Reset();
+	Keys.Reset();
+	Curves.Reset();
+	NumDuplicates = 0;
+
+	for (int32 i = 0; i < settings->AxisConfig.Num(); i++)
+	{
+		FName keyName = settings->AxisConfig[i].AxisKeyName;
+
+		//the last entry for a key wins, as in UPlayerInput
+		int32* existing = IndexByKey.Find(keyName);
+		if (existing)
+		{
+			*existing = i;
+			NumDuplicates++;
+			continue;
+		}
+
+		IndexByKey.Add(keyName, i);
+		Keys.Add(FKey(keyName));
+	}
+
+	NumEntries = settings->AxisConfig.Num();
+	BuiltGeneration = SettingsGeneration;
+	bBuilt = true;
+}
+
+void FAnalogConfigIndex::CompactBeforeEdit(UInputSettings* settings)
+{
+	if (NumDuplicates > 0)
+	{
+		CompactSettings(settings);
+		Build(settings);
+	}
+}
+
+int32 FAnalogConfigIndex::Find(FName keyName) const
+{
+	const int32* index = IndexByKey.Find(keyName);
+	return index ? *index : INDEX_NONE;
+}
+
+int32 FAnalogConfigIndex::FindOrAdd(UInputSettings* settings, FName keyName)
+{
+	CompactBeforeEdit(settings);
+
+	int32 index = Find(keyName);
+	if (index != INDEX_NONE)
+	{
+		return index;
+	}
+
+	index = settings->AxisConfig.Add(FInputAxisConfigEntry());
+	settings->AxisConfig[index].AxisKeyName = keyName;
+
+	IndexByKey.Add(keyName, index);
+	Keys.Add(FKey(keyName));
+	NumEntries++;
+
+	return index;
+}
+
+bool FAnalogConfigIndex::Remove(UInputSettings* settings, FName keyName)
+{
+	CompactBeforeEdit(settings);
+
+	int32 index = Find(keyName);
+	if (index == INDEX_NONE)
+	{
+		return false;
+	}
+
+	settings->AxisConfig.RemoveAtSwap(index);
+	IndexByKey.Remove(keyName);
+	Curves.Remove(keyName);
+	Keys.Remove(FKey(keyName));
+	NumEntries--;
+
+	//the last entry moved into the gap
+	if (index < settings->AxisConfig.Num())
+	{
+		IndexByKey.Add(settings->AxisConfig[index].AxisKeyName, index);
+	}
+
+	return true;
+}
+
+const FAnalogResponseCurve& FAnalogConfigIndex::GetCurve(UInputSettings* settings, FName keyName)
+{
+	int32 index = Find(keyName);
+	if (index == INDEX_NONE)
+	{
+		return IdentityCurve;
+	}
+
+	TSharedPtr<FAnalogResponseCurve>& curve = Curves.FindOrAdd(keyName);
+	if (!curve.IsValid())
+	{
+		curve = MakeShareable(new FAnalogResponseCurve(settings->AxisConfig[index].AxisProperties));
+	}
+
+	return *curve;
+}
+
+void FAnalogConfigIndex::InvalidateCurve(FName keyName)
+{
+	Curves.Remove(keyName);
+}
@@ -0,0 +1,71 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "GameFramework/InputSettings.h"
+#include "AnalogResponseCurve.h"
+
+/**
+ * Key-name index over UInputSettings::AxisConfig, with at most one entry per key. Older versions of
+ * AddAnalogConfig appended without checking, so duplicates loaded from a saved Input.ini are
+ * compacted at startup, keeping the last entry as UPlayerInput does. Building the index only reads
+ * the settings; any duplicates that slip in later are compacted by the next edit.
+ */
+class FAnalogConfigIndex
+{
+public:
+
+	/** The index for the settings, rebuilt if AxisConfig changed behind its back. */
+	static FAnalogConfigIndex& Get(UInputSettings* settings);
+
+	/** Removes all but the last entry for each key. Returns how many were removed. */
+	static int32 Compact(TArray<FInputAxisConfigEntry>& entries);
+
+	/** Compacts the settings' AxisConfig, e.g. after loading it, and marks it changed if anything was removed. */
+	static int32 CompactSettings(UInputSettings* settings);
+
+	/**
+	 * Call after changing AxisConfig without the edit functions below, e.g. after a ReloadConfig.
+	 * Bumps the settings generation, so the index rebuilds on its next Get.
+	 */
+	static void MarkSettingsChanged();
+
+	/** Position in AxisConfig, or INDEX_NONE. */
+	int32 Find(FName keyName) const;
+
+	int32 FindOrAdd(UInputSettings* settings, FName keyName);
+
+	bool Remove(UInputSettings* settings, FName keyName);
+
+	/** Response curve for the key, built on first use. Keys without a config get the identity curve. */
+	const FAnalogResponseCurve& GetCurve(UInputSettings* settings, FName keyName);
+
+	/** Drops the cached curve after the key's config was edited. */
+	void InvalidateCurve(FName keyName);
+
+	/** One per configured key, in AxisConfig order until entries are removed. */
+	const TArray<FKey>& GetKeys() const { return Keys; }
+
+private:
+
+	FAnalogConfigIndex();
+
+	void Build(const UInputSettings* settings);
+
+	/** Positions only stay valid through an edit once every key has a single entry. */
+	void CompactBeforeEdit(UInputSettings* settings);
+
+	TMap<FName, int32> IndexByKey;
+	TArray<FKey> Keys;
+
+	TMap<FName, TSharedPtr<FAnalogResponseCurve>> Curves;
+	FAnalogResponseCurve IdentityCurve;
+
+	//bumped by MarkSettingsChanged; the index is current while it matches BuiltGeneration
+	static int32 SettingsGeneration;
+	int32 BuiltGeneration;
+
+	int32 NumEntries;
+	int32 NumDuplicates;
+	bool bBuilt;
+};
@@ -0,0 +1,172 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ExtraConfigPrivatePCH.h"
+#include "AnalogResponseCurve.h"
+
+static FInputAxisProperties MakeIdentityProperties()
+{
+	FInputAxisProperties properties;
+	properties.DeadZone = 0.f;
+	properties.Exponent = 1.f;
+	properties.Sensitivity = 1.f;
+	properties.bInvert = false;
+	return properties;
+}
+
+const float FAnalogResponseCurve::MaxDeadZone = 0.99f;
+const float FAnalogResponseCurve::MaxError = 1e-4f;
+
+bool FAnalogResponseCurve::ClampProperties(FInputAxisProperties& properties)
+{
+	bool bChanged = false;
+
+	float deadZone = FMath::Clamp(properties.DeadZone, 0.f, MaxDeadZone);
+	if (deadZone != properties.DeadZone)
+	{
+		properties.DeadZone = deadZone;
+		bChanged = true;
+	}
+
+	if (properties.Exponent <= 0.f)
+	{
+		properties.Exponent = 1.f;
+		bChanged = true;
+	}
+
+	return bChanged;
+}
+
+FAnalogResponseCurve::FAnalogResponseCurve()
+	: FAnalogResponseCurve(MakeIdentityProperties())
+{
+}
+
+FAnalogResponseCurve::FAnalogResponseCurve(const FInputAxisProperties& properties)
+	: Properties(properties)
+{
+	ClampProperties(Properties);
+
+	Scale = Properties.bInvert ? -Properties.Sensitivity : Properties.Sensitivity;
+	DeadZoneScale = 1.f / (1.f - Properties.DeadZone);
+
+	//the lerp error grows with the curvature, which is unbounded at 0 for exponents under 1;
+	//from 16 entries on it stays below MaxError down to an exponent of 0.1
+	ExactBelow = Properties.Exponent < 1.f ? 16.f : 0.f;
+
+	for (int32 i = 0; i <= TableSize; i++)
+	{
+		Table[i] = FMath::Pow((float)i / TableSize, Properties.Exponent);
+	}
+}
+
+float FAnalogResponseCurve::EvaluateExact(const FInputAxisProperties& inProperties, float value)
+{
+	FInputAxisProperties properties = inProperties;
+	ClampProperties(properties);
+
+	if (properties.DeadZone > 0.f)
+	{
+		if (value > 0.f)
+		{
+			value = FMath::Max(0.f, value - properties.DeadZone) / (1.f - properties.DeadZone);
+		}
+		else
+		{
+			value = -FMath::Max(0.f, -value - properties.DeadZone) / (1.f - properties.DeadZone);
+		}
+	}
+
+	if (properties.Exponent != 1.f)
+	{
+		value = FMath::Sign(value) * FMath::Pow(FMath::Abs(value), properties.Exponent);
+	}
+
+	value *= properties.Sensitivity;
+
+	if (properties.bInvert)
+	{
+		value *= -1.f;
+	}
+
+	return value;
+}
+
+float FAnalogResponseCurve::LookupMagnitude(float magnitude) const
+{
+	float position = FMath::Max(0.f, magnitude - Properties.DeadZone) * DeadZoneScale * TableSize;
+	if (position < ExactBelow)
+	{
+		return FMath::Pow(position / TableSize, Properties.Exponent);
+	}
+
+	int32 index = FMath::Min((int32)position, TableSize - 1);
+	float alpha = position - index;
+
+	return Table[index] + (Table[index + 1] - Table[index]) * alpha;
+}
+
+float FAnalogResponseCurve::Evaluate(float value) const
+{
+	float magnitude = FMath::Abs(value);
+	if (magnitude > 1.f)
+	{
+		return EvaluateExact(Properties, value);
+	}
+
+	float response = LookupMagnitude(magnitude) * Scale;
+	return value < 0.f ? -response : response;
+}
+
+void FAnalogResponseCurve::EvaluateBatch(const float* in, float* out, int32 count) const
+{
+	const VectorRegister zero = VectorZero();
+	const VectorRegister one = VectorOne();
+	const VectorRegister deadZone = VectorSetFloat1(Properties.DeadZone);
+	const VectorRegister tableScale = VectorSetFloat1(DeadZoneScale * TableSize);
+	const VectorRegister scale = VectorSetFloat1(Scale);
+	const VectorRegister negativeScale = VectorSetFloat1(-Scale);
+
+	MS_ALIGN(16) float positions[4] GCC_ALIGN(16);
+	MS_ALIGN(16) float magnitudes[4] GCC_ALIGN(16);
+
+	int32 i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		VectorRegister value = VectorLoad(in + i);
+		VectorRegister magnitude = VectorAbs(value);
+
+		if (VectorAnyGreaterThan(magnitude, one))
+		{
+			for (int32 lane = 0; lane < 4; lane++)
+			{
+				out[i + lane] = Evaluate(in[i + lane]);
+			}
+			continue;
+		}
+
+		VectorStoreAligned(VectorMultiply(VectorMax(VectorSubtract(magnitude, deadZone), zero), tableScale), positions);
+
+		//the table gather is the only scalar step
+		for (int32 lane = 0; lane < 4; lane++)
+		{
+			if (positions[lane] < ExactBelow)
+			{
+				magnitudes[lane] = FMath::Pow(positions[lane] / TableSize, Properties.Exponent);
+				continue;
+			}
+
+			int32 index = FMath::Min((int32)positions[lane], TableSize - 1);
+			float alpha = positions[lane] - index;
+			magnitudes[lane] = Table[index] + (Table[index + 1] - Table[index]) * alpha;
+		}
+
+		//restore the sign and apply sensitivity and invert in one multiply
+		VectorRegister signedScale = VectorSelect(VectorCompareGE(value, zero), scale, negativeScale);
+		VectorStore(VectorMultiply(VectorLoadAligned(magnitudes), signedScale), out + i);
+	}
+
+	for (; i < count; i++)
+	{
+		out[i] = Evaluate(in[i]);
+	}
+}
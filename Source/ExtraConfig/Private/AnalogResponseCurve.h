@@ -0,0 +1,64 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "GameFramework/PlayerInput.h"
+
+/**
+ * Precomputed response of one analog axis config. The exponent is baked into a lookup table over
+ * the magnitude past the dead zone, so the dead zone kink sits exactly on the first table entry;
+ * sign, sensitivity and invert are applied on top, so a sample costs a table lerp instead of a
+ * pow. Matches UPlayerInput's axis massaging to within MaxError times the sensitivity.
+ */
+class FAnalogResponseCurve
+{
+public:
+
+	enum { TableSize = 512 };
+
+	//a dead zone of 1 or more divides by zero
+	static const float MaxDeadZone;
+
+	//largest difference from EvaluateExact per unit of sensitivity, for exponents of 0.1 to 10
+	static const float MaxError;
+
+	/**
+	 * Keeps DeadZone in [0, MaxDeadZone] and resets an Exponent <= 0, which would raise zero to a
+	 * negative power, to the engine default of 1. True if anything changed.
+	 */
+	static bool ClampProperties(FInputAxisProperties& properties);
+
+	/** Identity response: no dead zone, exponent 1, sensitivity 1. */
+	FAnalogResponseCurve();
+
+	explicit FAnalogResponseCurve(const FInputAxisProperties& properties);
+
+	float Evaluate(float value) const;
+
+	/**
+	 * Evaluates count samples, four at a time with SIMD. in and out may alias. Samples outside
+	 * [-1, 1], such as mouse deltas, fall back to the exact formula.
+	 */
+	void EvaluateBatch(const float* in, float* out, int32 count) const;
+
+	/** The reference scalar formula, with a pow per sample. Properties are clamped first. */
+	static float EvaluateExact(const FInputAxisProperties& properties, float value);
+
+private:
+
+	float LookupMagnitude(float magnitude) const;
+
+	//already clamped
+	FInputAxisProperties Properties;
+
+	//sensitivity, negated when inverted
+	float Scale;
+
+	//1 / (1 - DeadZone), mapping the magnitude past the dead zone onto the table
+	float DeadZoneScale;
+
+	//below this table position an exponent under 1 is too steep to lerp, so it is computed exactly
+	float ExactBelow;
+
+	float Table[TableSize + 1];
+};
@@ -0,0 +1,261 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ExtraConfigPrivatePCH.h"
+#include "ConfigBackend.h"
+#include "ConfigPersistence.h"
+#include "InputBindingIndex.h"
+#include "AnalogConfigIndex.h"
+#include "InputProfileStore.h"
+
+class FEngineConfigBackend : public IConfigBackend
+{
+public:
+
+	virtual bool GetString(const TCHAR* section, const TCHAR* key, FString& outValue, const FString& filename) override
+	{
+		return GConfig->GetString(section, key, outValue, filename);
+	}
+
+	virtual void SetString(const TCHAR* section, const TCHAR* key, const FString& value, const FString& filename) override
+	{
+		GConfig->SetString(section, key, *value, filename);
+	}
+
+	virtual int32 GetArray(const TCHAR* section, const TCHAR* key, TArray<FString>& outValues, const FString& filename) override
+	{
+		return GConfig->GetArray(section, key, outValues, filename);
+	}
+
+	virtual void SetArray(const TCHAR* section, const TCHAR* key, const TArray<FString>& values, const FString& filename) override
+	{
+		GConfig->SetArray(section, key, values, filename);
+	}
+
+	virtual void EmptySection(const TCHAR* section, const FString& filename) override
+	{
+		GConfig->EmptySection(section, filename);
+	}
+
+	virtual void QueueWrite(const FString& filename) override
+	{
+		FConfigPersistence::QueueWrite(filename);
+	}
+
+	virtual void WhenWritten(TFunction<void()> onWritten) override
+	{
+		FConfigPersistence::WhenWritten(onWritten);
+	}
+
+	virtual bool GetCVar(const TCHAR* name, int32& outValue) override
+	{
+		IConsoleVariable* cvar = IConsoleManager::Get().FindConsoleVariable(name);
+		if (!cvar)
+		{
+			return false;
+		}
+
+		outValue = cvar->GetInt();
+		return true;
+	}
+
+	virtual void SetCVar(const TCHAR* name, int32 value) override
+	{
+		IConsoleVariable* cvar = IConsoleManager::Get().FindConsoleVariable(name);
+		if (cvar)
+		{
+			//same priority the [ConsoleVariables] section is loaded with, so the live value always matches the ini
+			cvar->Set(*FString::FromInt(value), ECVF_SetByConsoleVariablesIni);
+		}
+	}
+
+	virtual void RecreateRenderState() override
+	{
+		FGlobalComponentReregisterContext recreateRenderState;
+	}
+
+	virtual UInputSettings* GetInputSettings() override
+	{
+		return UInputSettings::StaticClass()->GetDefaultObject<UInputSettings>();
+	}
+
+	virtual void SaveInputSettings() override
+	{
+		UInputSettings* Settings = GetInputSettings();
+
+		FScopedDeferredConfigWrite deferWrite(Settings->GetClass()->GetConfigName());
+		Settings->SaveConfig();
+	}
+
+	virtual void ReloadInputSettings() override
+	{
+		GetInputSettings()->ReloadConfig();
+	}
+
+	virtual void GetLocalPlayers(TArray<ULocalPlayer*>& outPlayers) override
+	{
+		//only the local players' inputs, rather than every UPlayerInput in the object array
+		for (const FWorldContext& context : GEngine->GetWorldContexts())
+		{
+			UWorld* world = context.World();
+			if (world)
+			{
+				outPlayers.Append(GEngine->GetGamePlayers(world));
+			}
+		}
+	}
+};
+
+static FEngineConfigBackend EngineBackend;
+static IConfigBackend* CurrentBackend = &EngineBackend;
+
+IConfigBackend& IConfigBackend::Get()
+{
+	return *CurrentBackend;
+}
+
+void IConfigBackend::Set(IConfigBackend* backend)
+{
+	check(IsInGameThread());
+
+	CurrentBackend = backend ? backend : &EngineBackend;
+
+	//the indices and the profile defaults were built from the old backend's settings
+	FInputBindingIndex::MarkSettingsChanged();
+	FAnalogConfigIndex::MarkSettingsChanged();
+	FInputProfileStore::Get().RefreshDefaults();
+}
+
+static FString MakeValueKey(const TCHAR* section, const TCHAR* key, const FString& filename)
+{
+	return FString::Printf(TEXT("%s|%s|%s"), *filename, section, key);
+}
+
+bool FMemoryConfigBackend::GetString(const TCHAR* section, const TCHAR* key, FString& outValue, const FString& filename)
+{
+	const FString* value = Values.Find(MakeValueKey(section, key, filename));
+	if (!value)
+	{
+		return false;
+	}
+
+	outValue = *value;
+	return true;
+}
+
+void FMemoryConfigBackend::SetString(const TCHAR* section, const TCHAR* key, const FString& value, const FString& filename)
+{
+	Values.Add(MakeValueKey(section, key, filename), value);
+}
+
+int32 FMemoryConfigBackend::GetArray(const TCHAR* section, const TCHAR* key, TArray<FString>& outValues, const FString& filename)
+{
+	outValues = Arrays.FindRef(MakeValueKey(section, key, filename));
+	return outValues.Num();
+}
+
+void FMemoryConfigBackend::SetArray(const TCHAR* section, const TCHAR* key, const TArray<FString>& values, const FString& filename)
+{
+	Arrays.Add(MakeValueKey(section, key, filename), values);
+}
+
+void FMemoryConfigBackend::EmptySection(const TCHAR* section, const FString& filename)
+{
+	FString prefix = MakeValueKey(section, TEXT(""), filename);
+
+	for (auto it = Values.CreateIterator(); it; ++it)
+	{
+		if (it.Key().StartsWith(prefix))
+		{
+			it.RemoveCurrent();
+		}
+	}
+
+	for (auto it = Arrays.CreateIterator(); it; ++it)
+	{
+		if (it.Key().StartsWith(prefix))
+		{
+			it.RemoveCurrent();
+		}
+	}
+}
+
+void FMemoryConfigBackend::QueueWrite(const FString& filename)
+{
+	Writes++;
+}
+
+void FMemoryConfigBackend::WhenWritten(TFunction<void()> onWritten)
+{
+	//nothing is ever pending
+	onWritten();
+}
+
+bool FMemoryConfigBackend::GetCVar(const TCHAR* name, int32& outValue)
+{
+	const int32* value = CVars.Find(name);
+	if (!value)
+	{
+		return false;
+	}
+
+	outValue = *value;
+	return true;
+}
+
+void FMemoryConfigBackend::SetCVar(const TCHAR* name, int32 value)
+{
+	CVars.Add(name, value);
+	CVarSets++;
+}
+
+void FMemoryConfigBackend::RecreateRenderState()
+{
+	Recreates++;
+}
+
+FMemoryConfigBackend::~FMemoryConfigBackend()
+{
+	if (InputSettings)
+	{
+		InputSettings->RemoveFromRoot();
+	}
+}
+
+UInputSettings* FMemoryConfigBackend::GetInputSettings()
+{
+	if (!InputSettings)
+	{
+		const UInputSettings* defaults = GetDefault<UInputSettings>();
+		SavedActionMappings = defaults->ActionMappings;
+		SavedAxisMappings = defaults->AxisMappings;
+		SavedAxisConfig = defaults->AxisConfig;
+
+		InputSettings = NewObject<UInputSettings>(GetTransientPackage());
+		InputSettings->AddToRoot();
+		ReloadInputSettings();
+	}
+
+	return InputSettings;
+}
+
+void FMemoryConfigBackend::SaveInputSettings()
+{
+	UInputSettings* settings = GetInputSettings();
+	SavedActionMappings = settings->ActionMappings;
+	SavedAxisMappings = settings->AxisMappings;
+	SavedAxisConfig = settings->AxisConfig;
+
+	InputSaves++;
+}
+
+void FMemoryConfigBackend::ReloadInputSettings()
+{
+	UInputSettings* settings = GetInputSettings();
+	settings->ActionMappings = SavedActionMappings;
+	settings->AxisMappings = SavedAxisMappings;
+	settings->AxisConfig = SavedAxisConfig;
+}
+
+void FMemoryConfigBackend::GetLocalPlayers(TArray<ULocalPlayer*>& outPlayers)
+{
+}
@@ -0,0 +1,109 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "GameFramework/InputSettings.h"
+
+/**
+ * Where the settings logic reads and writes config, console variables and input mappings. The
+ * default goes to GConfig, FConfigPersistence, IConsoleManager and the UInputSettings defaults
+ * object. Swapping in an FMemoryConfigBackend keeps everything in memory, so the caching,
+ * batching, apply, conflict lookup and save logic can be tested and benchmarked without touching
+ * the ini files, the renderer or the players. Display modes are swapped separately through
+ * FDisplayModeIndex::SetProvider.
+ *
+ * This is the seam in place of a standalone build: the logic behind it uses UE Core containers
+ * and strings, so it stays in the module and runs headless in the automation tests and
+ * ExtraConfig.BenchCore under -nullrhi instead of as a separate Linux target.
+ */
+class IConfigBackend
+{
+public:
+
+	virtual ~IConfigBackend() {}
+
+	virtual bool GetString(const TCHAR* section, const TCHAR* key, FString& outValue, const FString& filename) = 0;
+	virtual void SetString(const TCHAR* section, const TCHAR* key, const FString& value, const FString& filename) = 0;
+
+	/** Returns the number of values found. */
+	virtual int32 GetArray(const TCHAR* section, const TCHAR* key, TArray<FString>& outValues, const FString& filename) = 0;
+	virtual void SetArray(const TCHAR* section, const TCHAR* key, const TArray<FString>& values, const FString& filename) = 0;
+	virtual void EmptySection(const TCHAR* section, const FString& filename) = 0;
+
+	/** Hands a changed file to persistence. */
+	virtual void QueueWrite(const FString& filename) = 0;
+
+	/** Calls onWritten on the game thread once every file handed to QueueWrite so far is written. */
+	virtual void WhenWritten(TFunction<void()> onWritten) = 0;
+
+	/** Returns false if there is no such console variable. */
+	virtual bool GetCVar(const TCHAR* name, int32& outValue) = 0;
+	virtual void SetCVar(const TCHAR* name, int32 value) = 0;
+
+	virtual void RecreateRenderState() = 0;
+
+	/** The mappings and analog config UInputConfig edits. */
+	virtual UInputSettings* GetInputSettings() = 0;
+
+	/** Queues the input settings for writing; ReloadInputSettings drops edits made since. */
+	virtual void SaveInputSettings() = 0;
+	virtual void ReloadInputSettings() = 0;
+
+	/** Local players whose UPlayerInput picks up saved input settings. */
+	virtual void GetLocalPlayers(TArray<ULocalPlayer*>& outPlayers) = 0;
+
+	static IConfigBackend& Get();
+
+	/**
+	 * Replaces the backend; pass nullptr to restore the engine one. The input indices are rebuilt
+	 * from the new backend's settings on their next use. Game thread only.
+	 */
+	static void Set(IConfigBackend* backend);
+};
+
+/**
+ * In-memory backend for tests and benchmarks. Counts the work that would have reached the engine.
+ * Input settings live in a transient copy of the defaults object, created on first use, and
+ * there are no players.
+ */
+class FMemoryConfigBackend : public IConfigBackend
+{
+public:
+
+	FMemoryConfigBackend() : Writes(0), CVarSets(0), Recreates(0), InputSaves(0), InputSettings(nullptr) {}
+	virtual ~FMemoryConfigBackend();
+
+	virtual bool GetString(const TCHAR* section, const TCHAR* key, FString& outValue, const FString& filename) override;
+	virtual void SetString(const TCHAR* section, const TCHAR* key, const FString& value, const FString& filename) override;
+	virtual int32 GetArray(const TCHAR* section, const TCHAR* key, TArray<FString>& outValues, const FString& filename) override;
+	virtual void SetArray(const TCHAR* section, const TCHAR* key, const TArray<FString>& values, const FString& filename) override;
+	virtual void EmptySection(const TCHAR* section, const FString& filename) override;
+	virtual void QueueWrite(const FString& filename) override;
+	virtual void WhenWritten(TFunction<void()> onWritten) override;
+	virtual bool GetCVar(const TCHAR* name, int32& outValue) override;
+	virtual void SetCVar(const TCHAR* name, int32 value) override;
+	virtual void RecreateRenderState() override;
+	virtual UInputSettings* GetInputSettings() override;
+	virtual void SaveInputSettings() override;
+	virtual void ReloadInputSettings() override;
+	virtual void GetLocalPlayers(TArray<ULocalPlayer*>& outPlayers) override;
+
+	//file|section|key
+	TMap<FString, FString> Values;
+	TMap<FString, TArray<FString>> Arrays;
+	TMap<FString, int32> CVars;
+
+	int32 Writes;
+	int32 CVarSets;
+	int32 Recreates;
+	int32 InputSaves;
+
+	//what ReloadInputSettings goes back to: the defaults object's values, then each save
+	TArray<FInputActionKeyMapping> SavedActionMappings;
+	TArray<FInputAxisKeyMapping> SavedAxisMappings;
+	TArray<FInputAxisConfigEntry> SavedAxisConfig;
+
+private:
+
+	UInputSettings* InputSettings;
+};
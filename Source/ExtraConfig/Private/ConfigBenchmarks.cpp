@@ -0,0 +1,363 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ExtraConfigPrivatePCH.h"
+#include "ConfigBenchmarks.h"
+#include "GraphicsConfig.h"
+#include "InputConfig.h"
+#include "ConfigBackend.h"
+#include "ConfigDelta.h"
+#include "InputBindingIndex.h"
+#include "ConfigSnapshot.h"
+#include "HardwareDetection.h"
+#include "GraphicsSettingDescriptors.h"
+#include "SettingsCache.h"
+
+// ---------------
+// Benchmark suite
+// ---------------
+
+//Runs the settings logic against FMemoryConfigBackend, so nothing reaches the ini files or the
+//renderer, and compares each case with the baselines saved by an earlier run on the same machine.
+
+struct FBenchCase
+{
+	FString Name;
+	int32 Iterations;
+	TFunction<void(int32)> Run;
+	//untimed, before the warm-up pass
+	TFunction<void()> Setup;
+
+	FBenchCase(const FString& name, int32 iterations, TFunction<void(int32)> run, TFunction<void()> setup = nullptr)
+		: Name(name), Iterations(iterations), Run(run), Setup(setup)
+	{}
+};
+
+FString FConfigBenchBaselines::GetFilename()
+{
+	return FPaths::GameSavedDir() / TEXT("ExtraConfigBenchBaselines.txt");
+}
+
+//name=nanoseconds per operation, one per line
+TMap<FString, double> FConfigBenchBaselines::Load()
+{
+	TMap<FString, double> baselines;
+
+	FString text;
+	if (!FFileHelper::LoadFileToString(text, *GetFilename()))
+	{
+		return baselines;
+	}
+
+	TArray<FString> lines;
+	text.ParseIntoArrayLines(lines);
+
+	for (const FString& line : lines)
+	{
+		FString name;
+		FString value;
+		if (line.Split(TEXT("="), &name, &value))
+		{
+			baselines.Add(name, FCString::Atod(*value));
+		}
+	}
+
+	return baselines;
+}
+
+void FConfigBenchBaselines::Save(const TMap<FString, double>& results)
+{
+	FString text;
+	for (const auto& entry : results)
+	{
+		text += FString::Printf(TEXT("%s=%.2f\r\n"), *entry.Key, entry.Value);
+	}
+
+	FFileHelper::SaveStringToFile(text, *GetFilename());
+}
+
+static void MakeBenchMappings(int32 count, TArray<FKey>& outKeys, TArray<FInputActionKeyMapping>& outActions, TArray<FInputAxisKeyMapping>& outAxes)
+{
+	const int32 keyCount = 200;
+	for (int32 i = 0; i < keyCount; i++)
+	{
+		outKeys.Add(FKey(FName(*FString::Printf(TEXT("BenchKey%d"), i))));
+	}
+
+	for (int32 i = 0; i < count; i++)
+	{
+		FName name(*FString::Printf(TEXT("BenchBinding%d"), i));
+		if (i % 4 == 0)
+		{
+			outAxes.Add(FInputAxisKeyMapping(name, outKeys[i % keyCount], 1.f));
+		}
+		else
+		{
+			outActions.Add(FInputActionKeyMapping(name, outKeys[i % keyCount], (i & 1) != 0, (i & 2) != 0));
+		}
+	}
+}
+
+static void MakeBenchConfigFiles(int32 count, FConfigFile& outDefaults, FConfigFile& outCurrent)
+{
+	const TCHAR* section = TEXT("/Script/Engine.InputSettings");
+	FConfigSection& defaults = outDefaults.FindOrAdd(section);
+	FConfigSection& current = outCurrent.FindOrAdd(section);
+
+	for (int32 i = 0; i < count; i++)
+	{
+		FString value = FString::Printf(TEXT("(ActionName=\"Bench%d\",Key=BenchKey%d,bShift=False,bCtrl=False,bAlt=False,bCmd=False)"), i, i % 200);
+		defaults.Add(TEXT("ActionMappings"), value);
+
+		//one in ten rebound
+		current.Add(TEXT("ActionMappings"), i % 10 == 0 ? value.Replace(TEXT("BenchKey"), TEXT("Rebound")) : value);
+	}
+
+	defaults.Add(TEXT("bAlwaysShowTouchInterface"), TEXT("False"));
+	current.Add(TEXT("bAlwaysShowTouchInterface"), TEXT("False"));
+}
+
+static void BenchCore(const TArray<FString>& args)
+{
+	bool bSave = args.Contains(TEXT("-save"));
+	float threshold = 0.1f;
+	for (const FString& arg : args)
+	{
+		FParse::Value(*arg, TEXT("-threshold="), threshold);
+	}
+
+	//start the in-memory backend from the real values, so restoring them at the end leaves
+	//nothing queued for the next map load or restart
+	FGraphicsSettings original = UGraphicsConfig::GetGraphicsSettings();
+
+	FMemoryConfigBackend memory;
+	for (const FGraphicsSettingDescriptor& desc : GraphicsSettingDescriptors)
+	{
+		memory.SetString(TEXT("ConsoleVariables"), desc.CVarName, FString::FromInt(desc.Get(original)), GEngineIni);
+		memory.CVars.Add(desc.CVarName, desc.Get(original));
+	}
+
+	IConfigBackend::Set(&memory);
+	UGraphicsConfig::InvalidateGraphicsSettings();
+
+	FGraphicsSettings low = FHardwareDetection::MakePresetSettings(EQuality::Low);
+	FGraphicsSettings high = FHardwareDetection::MakePresetSettings(EQuality::High);
+
+	//every value of every setting has to read back as written, clamped to the setting's range
+	int32 roundTripErrors = 0;
+	for (const FGraphicsSettingDescriptor& desc : GraphicsSettingDescriptors)
+	{
+		for (int32 value = desc.MinValue - 1; value <= desc.MaxValue + 1; value++)
+		{
+			UGraphicsConfig::SetGraphicsSetting(desc.Setting, value);
+
+			int32 cached = UGraphicsConfig::GetGraphicsSetting(desc.Setting);
+			int32 stored = desc.Get(UGraphicsConfig::ReadGraphicsSettingsFromConfig());
+			if (cached != desc.Clamp(value) || stored != cached)
+			{
+				UE_LOG(LogExtraConfig, Warning, TEXT("%s: wrote %d, read back %d cached and %d from config"), desc.CVarName, value, cached, stored);
+				roundTripErrors++;
+			}
+		}
+	}
+
+	TArray<FBenchCase> cases;
+	cases.Add(FBenchCase(TEXT("get_cached"), 100000, [](int32 i) { UGraphicsConfig::GetGraphicsSettings(); }));
+	cases.Add(FBenchCase(TEXT("get_uncached"), 10000, [](int32 i) { UGraphicsConfig::ReadGraphicsSettingsFromConfig(); }));
+	cases.Add(FBenchCase(TEXT("set"), 10000, [](int32 i)
+		{
+			UGraphicsConfig::SetGraphicsSetting((EGraphicsSetting)(i % (int32)EGraphicsSetting::MAX), (i / (int32)EGraphicsSetting::MAX) % 4);
+		}));
+	cases.Add(FBenchCase(TEXT("batch_commit"), 1000, [&low, &high](int32 i) { UGraphicsConfig::ApplyGraphicsSettings((i & 1) ? low : high); }));
+
+	//binding paths at 100, 1k and 10k mappings
+	struct FBindingFixture
+	{
+		TArray<FKey> Keys;
+		TArray<FInputActionKeyMapping> Actions;
+		TArray<FInputAxisKeyMapping> Axes;
+		FInputBindingIndex Index;
+		TArray<FName> Conflicts;
+		FConfigFile DefaultsFile;
+		FConfigFile CurrentFile;
+	};
+
+	const int32 sizes[] = { 100, 1000, 10000 };
+	TArray<TSharedRef<FBindingFixture>> fixtures;
+
+	for (int32 size : sizes)
+	{
+		TSharedRef<FBindingFixture> fixture = MakeShareable(new FBindingFixture());
+		MakeBenchMappings(size, fixture->Keys, fixture->Actions, fixture->Axes);
+		fixture->Index.Build(fixture->Actions, fixture->Axes);
+		MakeBenchConfigFiles(size, fixture->DefaultsFile, fixture->CurrentFile);
+		fixtures.Add(fixture);
+
+		FBindingFixture* f = &fixture.Get();
+		FString suffix = FString::Printf(TEXT("_%d"), size);
+
+		cases.Add(FBenchCase(TEXT("double_bound") + suffix, 100000, [f](int32 i)
+			{
+				f->Index.IsBoundToOther(f->Keys[i % f->Keys.Num()], FName(TEXT("BenchBinding0")));
+			}));
+		cases.Add(FBenchCase(TEXT("conflict_lookup") + suffix, 100000, [f](int32 i)
+			{
+				f->Conflicts.Reset();
+				f->Index.GetConflicts(f->Keys[i % f->Keys.Num()], (uint8)(i & 3), f->Conflicts);
+			}));
+		cases.Add(FBenchCase(TEXT("keys_for_action") + suffix, 100000, [f](int32 i)
+			{
+				f->Index.GetActionMaps(f->Actions[i % f->Actions.Num()].ActionName);
+			}));
+		//the index rebuild SaveChanges and DiscardChanges pay, and the delta the writer produces
+		cases.Add(FBenchCase(TEXT("index_rebuild") + suffix, FMath::Max(10, 100000 / size), [f](int32 i)
+			{
+				f->Index.Build(f->Actions, f->Axes);
+			}));
+		cases.Add(FBenchCase(TEXT("save_delta") + suffix, FMath::Max(10, 50000 / size), [f](int32 i)
+			{
+				FConfigDelta::MakeDeltaText(f->DefaultsFile, f->CurrentFile);
+			}));
+		//one rebound key committed through UInputConfig, as from the menu; the backend's copy of the
+		//input settings holds the fixture, so nothing reaches Input.ini or the players
+		cases.Add(FBenchCase(TEXT("save_changes") + suffix, FMath::Max(5, 5000 / size), [f](int32 i)
+			{
+				const FInputActionKeyMapping& mapping = f->Actions[0];
+				UInputConfig::ModifyActionMapping(mapping.ActionName, mapping.Key, (i & 1) != 0, true, false, false);
+				UInputConfig::SaveChanges();
+			}, [f]()
+			{
+				UInputSettings* settings = IConfigBackend::Get().GetInputSettings();
+				settings->ActionMappings = f->Actions;
+				settings->AxisMappings = f->Axes;
+				FInputBindingIndex::MarkSettingsChanged();
+			}));
+	}
+
+	TMap<FString, double> baselines = FConfigBenchBaselines::Load();
+	TMap<FString, double> results;
+	int32 regressions = 0;
+
+	for (FBenchCase& bench : cases)
+	{
+		if (bench.Setup)
+		{
+			bench.Setup();
+		}
+
+		//one untimed pass to warm caches
+		bench.Run(0);
+
+		double start = FPlatformTime::Seconds();
+		for (int32 i = 0; i < bench.Iterations; i++)
+		{
+			bench.Run(i);
+		}
+		double nsPerOp = (FPlatformTime::Seconds() - start) * 1e9 / bench.Iterations;
+
+		results.Add(bench.Name, nsPerOp);
+
+		const double* baseline = baselines.Find(bench.Name);
+		if (baseline && *baseline > 0.0)
+		{
+			double change = nsPerOp / *baseline - 1.0;
+			bool bRegressed = change > threshold;
+			regressions += bRegressed ? 1 : 0;
+
+			UE_LOG(LogExtraConfig, Display, TEXT("%-24s %10.1f ns/op  baseline %10.1f  %+6.1f%%%s"),
+				*bench.Name, nsPerOp, *baseline, change * 100.0, bRegressed ? TEXT("  REGRESSED") : TEXT(""));
+		}
+		else
+		{
+			UE_LOG(LogExtraConfig, Display, TEXT("%-24s %10.1f ns/op  no baseline"), *bench.Name, nsPerOp);
+		}
+	}
+
+	if (roundTripErrors > 0)
+	{
+		UE_LOG(LogExtraConfig, Warning, TEXT("%d graphics settings failed to round-trip"), roundTripErrors);
+	}
+
+	UE_LOG(LogExtraConfig, Display, TEXT("Backend saw %d writes, %d cvar sets, %d render state recreations"),
+		memory.Writes, memory.CVarSets, memory.Recreates);
+
+	UGraphicsConfig::ApplyGraphicsSettings(original);
+	IConfigBackend::Set(nullptr);
+	UGraphicsConfig::InvalidateGraphicsSettings();
+
+	//SaveChanges published the fixture mappings
+	FConfigSnapshot::PublishCurrent();
+
+	if (bSave)
+	{
+		FConfigBenchBaselines::Save(results);
+		UE_LOG(LogExtraConfig, Display, TEXT("Saved baselines to %s"), *FConfigBenchBaselines::GetFilename());
+	}
+	else if (regressions > 0)
+	{
+		UE_LOG(LogExtraConfig, Warning, TEXT("%d cases more than %.0f%% slower than baseline"), regressions, threshold * 100.f);
+	}
+}
+
+static FAutoConsoleCommand BenchCoreCommand(
+	TEXT("ExtraConfig.BenchCore"),
+	TEXT("Benchmarks get, set, batch commit, conflict lookup, delta save and SaveChanges against an in-memory backend. -save records baselines, -threshold=0.1 sets the regression margin."),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&BenchCore));
+
+// -------------
+// Startup cache
+// -------------
+
+//Times the plugin's share of startup both ways against the real ini files, without applying
+//anything: a cache hit reads the cache, a miss reads every setting from the engine ini and parses
+//the shipped defaults of each managed file for the delta migration.
+static void BenchStartup(const TArray<FString>& args)
+{
+	int32 iterations = 20;
+	for (const FString& arg : args)
+	{
+		FParse::Value(*arg, TEXT("-iterations="), iterations);
+	}
+	iterations = FMath::Max(1, iterations);
+
+	FGraphicsSettings graphics;
+	if (!FSettingsCache::Read(graphics))
+	{
+		UE_LOG(LogExtraConfig, Display, TEXT("No valid settings cache at %s; restart once the game has shut down cleanly"), *FSettingsCache::GetFilename());
+		return;
+	}
+
+	double start = FPlatformTime::Seconds();
+	for (int32 i = 0; i < iterations; i++)
+	{
+		FSettingsCache::Read(graphics);
+	}
+	double hitMs = (FPlatformTime::Seconds() - start) * 1000.0 / iterations;
+
+	const FString* filenames[] = { &GInputIni, &GEngineIni, &GGameIni, &GGameUserSettingsIni };
+	const TCHAR* baseIniNames[] = { TEXT("Input"), TEXT("Engine"), TEXT("Game"), TEXT("GameUserSettings") };
+
+	start = FPlatformTime::Seconds();
+	for (int32 i = 0; i < iterations; i++)
+	{
+		UGraphicsConfig::ReadGraphicsSettingsFromConfig();
+
+		for (int32 j = 0; j < ARRAY_COUNT(filenames); j++)
+		{
+			FConfigFile defaults;
+			FConfigFile* file = GConfig->Find(*filenames[j], false);
+			if (FConfigDelta::LoadDefaults(baseIniNames[j], defaults) && file)
+			{
+				FConfigDelta::MakeDeltaText(defaults, *file);
+			}
+		}
+	}
+	double missMs = (FPlatformTime::Seconds() - start) * 1000.0 / iterations;
+
+	UE_LOG(LogExtraConfig, Display, TEXT("Startup with the settings cache %8.2f ms, without %8.2f ms, saved %8.2f ms"),
+		hitMs, missMs, missMs - hitMs);
+}
+
+static FAutoConsoleCommand BenchStartupCommand(
+	TEXT("ExtraConfig.BenchStartup"),
+	TEXT("Times the plugin's startup work with and without the settings cache. -iterations=20 sets the number of runs."),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&BenchStartup));
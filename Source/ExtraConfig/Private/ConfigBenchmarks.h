@@ -0,0 +1,20 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+/**
+ * Per-operation timings recorded by ExtraConfig.BenchCore -save on this machine, in nanoseconds
+ * by case name (get_cached, double_bound_1000, ...). BenchCore compares each run with them, and
+ * the performance automation test derives its budgets from them.
+ */
+class FConfigBenchBaselines
+{
+public:
+
+	static FString GetFilename();
+
+	/** Empty if nothing has been saved yet. */
+	static TMap<FString, double> Load();
+
+	static void Save(const TMap<FString, double>& results);
+};
@@ -0,0 +1,151 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ExtraConfigPrivatePCH.h"
+#include "ConfigDelta.h"
+
+bool FConfigDelta::LoadDefaults(const FString& baseIniName, FConfigFile& outDefaults)
+{
+	//an empty generated dir keeps the user's saved file out of the hierarchy
+	FString scratchDir = FPaths::GameIntermediateDir() / TEXT("ExtraConfigDefaults/");
+
+	return FConfigCacheIni::LoadExternalIniFile(outDefaults, *baseIniName, *FPaths::EngineConfigDir(), *FPaths::SourceConfigDir(),
+		true, ANSI_TO_TCHAR(FPlatformProperties::PlatformName()), true, false, true, *scratchDir);
+}
+
+//FString == and < ignore case, which would hide edits such as a changed key name casing
+static bool LessExact(const FString& a, const FString& b)
+{
+	return a.Compare(b, ESearchCase::CaseSensitive) < 0;
+}
+
+//Appends the lines that turn the default entries of an array into the current ones. The engine's
+//-Key= removes a single matching entry and +Key= adds nothing if an equal entry (ignoring case)
+//exists, so values are counted: one - per default copy too many, and per current copy too many a
+//+ for a value new to the defaults, .Key= (which always adds) for the rest. Removals go first.
+//Both arrays are sorted so large mapping lists diff in n log n rather than with a scan per entry.
+static void AppendArrayDelta(const FString& key, TArray<FString>& defaultValues, TArray<FString>& currentValues, FString& out)
+{
+	defaultValues.Sort(&LessExact);
+	currentValues.Sort(&LessExact);
+
+	FString additions;
+
+	//FString hashes and compares without case, like the engine's +
+	TSet<FString> defaultSet;
+	defaultSet.Append(defaultValues);
+
+	int32 d = 0;
+	int32 c = 0;
+	while (d < defaultValues.Num() || c < currentValues.Num())
+	{
+		int32 order = d == defaultValues.Num() ? 1
+			: c == currentValues.Num() ? -1
+			: defaultValues[d].Compare(currentValues[c], ESearchCase::CaseSensitive);
+
+		const FString& value = order <= 0 ? defaultValues[d] : currentValues[c];
+
+		int32 defaultCount = 0;
+		while (order <= 0 && d < defaultValues.Num() && defaultValues[d].Equals(value, ESearchCase::CaseSensitive))
+		{
+			defaultCount++;
+			d++;
+		}
+
+		int32 currentCount = 0;
+		while (order >= 0 && c < currentValues.Num() && currentValues[c].Equals(value, ESearchCase::CaseSensitive))
+		{
+			currentCount++;
+			c++;
+		}
+
+		for (int32 i = currentCount; i < defaultCount; i++)
+		{
+			out += FString::Printf(TEXT("-%s=%s\r\n"), *key, *value);
+		}
+
+		for (int32 i = defaultCount; i < currentCount; i++)
+		{
+			bool bUnique = i == 0 && !defaultSet.Contains(value);
+			additions += FString::Printf(TEXT("%s%s=%s\r\n"), bUnique ? TEXT("+") : TEXT("."), *key, *value);
+		}
+	}
+
+	out += additions;
+}
+
+static void AppendSectionDelta(const FConfigSection* defaults, const FConfigSection& current, FString& out)
+{
+	TArray<FName> keys;
+	current.GetKeys(keys);
+
+	TArray<FString> currentValues;
+	TArray<FString> defaultValues;
+
+	for (const FName& key : keys)
+	{
+		currentValues.Reset();
+		defaultValues.Reset();
+
+		current.MultiFind(key, currentValues, true);
+		if (defaults)
+		{
+			defaults->MultiFind(key, defaultValues, true);
+		}
+
+		FString keyString = key.ToString();
+
+		if (currentValues.Num() == 1 && defaultValues.Num() <= 1)
+		{
+			if (defaultValues.Num() == 0 || !defaultValues[0].Equals(currentValues[0], ESearchCase::CaseSensitive))
+			{
+				out += FString::Printf(TEXT("%s=%s\r\n"), *keyString, *currentValues[0]);
+			}
+			continue;
+		}
+
+		AppendArrayDelta(keyString, defaultValues, currentValues, out);
+	}
+
+	//keys dropped entirely, e.g. the last entry of an array removed
+	if (defaults)
+	{
+		TArray<FName> defaultKeys;
+		defaults->GetKeys(defaultKeys);
+
+		for (const FName& key : defaultKeys)
+		{
+			if (current.Contains(key))
+			{
+				continue;
+			}
+
+			defaultValues.Reset();
+			defaults->MultiFind(key, defaultValues, true);
+
+			for (const FString& value : defaultValues)
+			{
+				out += FString::Printf(TEXT("-%s=%s\r\n"), *key.ToString(), *value);
+			}
+		}
+	}
+}
+
+FString FConfigDelta::MakeDeltaText(const FConfigFile& defaults, const FConfigFile& current)
+{
+	FString text;
+	FString sectionText;
+
+	for (const auto& section : current)
+	{
+		sectionText.Reset();
+		AppendSectionDelta(defaults.Find(section.Key), section.Value, sectionText);
+
+		//sections that match the defaults are left out entirely
+		if (sectionText.Len() > 0)
+		{
+			text += FString::Printf(TEXT("[%s]\r\n%s\r\n"), *section.Key, *sectionText);
+		}
+	}
+
+	return text;
+}
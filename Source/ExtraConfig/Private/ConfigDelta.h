@@ -0,0 +1,23 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "Runtime/Core/Public/Misc/ConfigCacheIni.h"
+
+/**
+ * Builds saved ini files that hold only what differs from the shipped defaults. Keys with a
+ * single value are written as Key=Value when they differ; multi-value keys such as ActionMappings
+ * are written as -Key= and +Key= or .Key= lines, one per entry removed or added, so the engine's
+ * own hierarchy merge rebuilds the full list, duplicates included, at load. Entry order within an
+ * array is not preserved.
+ */
+class FConfigDelta
+{
+public:
+
+	/** Loads the Base/Default/platform hierarchy for an ini without the user's saved layer. */
+	static bool LoadDefaults(const FString& baseIniName, FConfigFile& outDefaults);
+
+	/** Ini text for the keys in current that override defaults. */
+	static FString MakeDeltaText(const FConfigFile& defaults, const FConfigFile& current);
+};
@@ -0,0 +1,85 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "Engine.h"
+#include "LatentActions.h"
+
+/**
+ * Latent Blueprint node for one of the async config requests. The request's callback only fills a
+ * shared state, so it stays safe to call after the node's world is gone; the result is copied to
+ * the node's output on the next latent update.
+ */
+template<typename ResultType>
+class TConfigLatentAction : public FPendingLatentAction
+{
+public:
+
+	typedef TFunction<void(const ResultType&)> FCallback;
+
+	/**
+	 * Registers a node for latentInfo and hands its callback to request. Does nothing if the same
+	 * node is already waiting, so pressing a button twice doesn't queue a second request.
+	 */
+	static void Start(UObject* worldContextObject, const FLatentActionInfo& latentInfo, ResultType* output, TFunction<void(FCallback)> request)
+	{
+		UWorld* world = GEngine->GetWorldFromContextObject(worldContextObject);
+		if (!world)
+		{
+			return;
+		}
+
+		FLatentActionManager& manager = world->GetLatentActionManager();
+		if (manager.FindExistingAction<TConfigLatentAction>(latentInfo.CallbackTarget, latentInfo.UUID))
+		{
+			return;
+		}
+
+		TConfigLatentAction* action = new TConfigLatentAction(latentInfo, output);
+		manager.AddNewAction(latentInfo.CallbackTarget, latentInfo.UUID, action);
+
+		TSharedRef<FState, ESPMode::ThreadSafe> state = action->State;
+		request([state](const ResultType& result)
+		{
+			state->Result = result;
+			state->bDone = true;
+		});
+	}
+
+	virtual void UpdateOperation(FLatentResponse& response) override
+	{
+		if (State->bDone && Output)
+		{
+			*Output = State->Result;
+		}
+
+		response.FinishAndTriggerIf(State->bDone, ExecutionFunction, OutputLink, CallbackTarget);
+	}
+
+private:
+
+	struct FState
+	{
+		bool bDone;
+		ResultType Result;
+
+		FState() : bDone(false), Result() {}
+	};
+
+	TConfigLatentAction(const FLatentActionInfo& latentInfo, ResultType* output)
+		: ExecutionFunction(latentInfo.ExecutionFunction)
+		, OutputLink(latentInfo.Linkage)
+		, CallbackTarget(latentInfo.CallbackTarget)
+		, Output(output)
+		, State(MakeShareable(new FState()))
+	{}
+
+	FName ExecutionFunction;
+	int32 OutputLink;
+	FWeakObjectPtr CallbackTarget;
+
+	//the node's output pin; nullptr for nodes without one
+	ResultType* Output;
+
+	TSharedRef<FState, ESPMode::ThreadSafe> State;
+};
@@ -0,0 +1,561 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ExtraConfigPrivatePCH.h"
+#include "ConfigLint.h"
+#include "GraphicsSettingDescriptors.h"
+#include "InputBindingIndex.h"
+#include "AnalogResponseCurve.h"
+
+static const TCHAR* InputSettingsSection = TEXT("/Script/Engine.InputSettings");
+static const TCHAR* ActionMappingsKey = TEXT("ActionMappings");
+static const TCHAR* AxisMappingsKey = TEXT("AxisMappings");
+static const TCHAR* AxisConfigKey = TEXT("AxisConfig");
+
+void FConfigLintResult::Accumulate(const FConfigLintResult& other)
+{
+	DuplicateMappings += other.DuplicateMappings;
+	DuplicateAxisConfigs += other.DuplicateAxisConfigs;
+	DuplicateKeys += other.DuplicateKeys;
+	InvalidMappings += other.InvalidMappings;
+	ClampedValues += other.ClampedValues;
+	MergedSections += other.MergedSections;
+	ConflictingKeys += other.ConflictingKeys;
+	UnparsedEntries += other.UnparsedEntries;
+}
+
+struct FLintLine
+{
+	//0 for a plain Key=Value line, otherwise the + - . ! prefix
+	TCHAR Op;
+	//empty for comments, which are kept verbatim in Raw
+	FString Key;
+	FString Value;
+	FString Raw;
+	bool bRemoved;
+
+	FLintLine() : Op(0), bRemoved(false) {}
+};
+
+struct FLintSection
+{
+	FString Name;
+	TArray<FLintLine> Lines;
+};
+
+//Sections where GraphicsSettingDescriptors console variables are stored
+static bool IsCVarSection(const FString& section)
+{
+	return section == TEXT("ConsoleVariables") || section == TEXT("SystemSettings")
+		|| section == TEXT("ScalabilityGroups") || section == TEXT("ExtraConfig.HardwareDetection");
+}
+
+static const FGraphicsSettingDescriptor* FindDescriptor(const FString& cvarName)
+{
+	for (const FGraphicsSettingDescriptor& desc : GraphicsSettingDescriptors)
+	{
+		if (cvarName == desc.CVarName)
+		{
+			return &desc;
+		}
+	}
+
+	return nullptr;
+}
+
+static FString Unquote(const FString& value)
+{
+	if (value.Len() >= 2 && value[0] == '"' && value[value.Len() - 1] == '"')
+	{
+		return value.Mid(1, value.Len() - 2);
+	}
+
+	return value;
+}
+
+//Splits "(A=1,B=(C=2),D="x,y")" into its top level fields in order. Values keep their quotes and
+//nested structs stay as text, so WriteStruct gives back the original.
+static bool ParseStruct(const FString& text, TMap<FString, FString>& outFields)
+{
+	if (text.Len() < 2 || text[0] != '(' || text[text.Len() - 1] != ')')
+	{
+		return false;
+	}
+
+	int32 depth = 0;
+	bool bQuoted = false;
+	int32 start = 1;
+
+	for (int32 i = 1; i < text.Len(); i++)
+	{
+		TCHAR c = text[i];
+
+		if (bQuoted)
+		{
+			bQuoted = c != '"';
+			continue;
+		}
+
+		if (c == '"')
+		{
+			bQuoted = true;
+		}
+		else if (c == '(')
+		{
+			depth++;
+		}
+		else if (c == ')' && depth > 0)
+		{
+			depth--;
+		}
+		else if ((c == ',' && depth == 0) || i == text.Len() - 1)
+		{
+			FString field = text.Mid(start, i - start).Trim().TrimTrailing();
+			start = i + 1;
+
+			FString name;
+			FString value;
+			if (field.Split(TEXT("="), &name, &value))
+			{
+				outFields.Add(name.TrimTrailing(), value.Trim());
+			}
+			else if (!field.IsEmpty())
+			{
+				return false;
+			}
+		}
+	}
+
+	return !bQuoted && depth == 0;
+}
+
+static FString WriteStruct(const TMap<FString, FString>& fields)
+{
+	FString text = TEXT("(");
+
+	for (const auto& field : fields)
+	{
+		if (text.Len() > 1)
+		{
+			text += TEXT(",");
+		}
+
+		text += field.Key + TEXT("=") + field.Value;
+	}
+
+	return text + TEXT(")");
+}
+
+static bool GetBoolField(const TMap<FString, FString>& fields, const TCHAR* name)
+{
+	const FString* value = fields.Find(name);
+	return value && FCString::ToBool(**value);
+}
+
+static bool HasMappingKey(const FString& name, const FString& key)
+{
+	return !name.IsEmpty() && !key.IsEmpty() && key != TEXT("None");
+}
+
+//The mapping the engine loads from the fields, so duplicates are found with its own operator==.
+//False for mappings the engine can't use.
+static bool ParseMapping(const TMap<FString, FString>& fields, FInputActionKeyMapping& outMapping)
+{
+	FString name = Unquote(fields.FindRef(TEXT("ActionName")));
+	FString key = Unquote(fields.FindRef(TEXT("Key")));
+	if (!HasMappingKey(name, key))
+	{
+		return false;
+	}
+
+	outMapping = FInputActionKeyMapping(FName(*name), FKey(FName(*key)),
+		GetBoolField(fields, TEXT("bShift")), GetBoolField(fields, TEXT("bCtrl")), GetBoolField(fields, TEXT("bAlt")), GetBoolField(fields, TEXT("bCmd")));
+	return true;
+}
+
+static bool ParseMapping(const TMap<FString, FString>& fields, FInputAxisKeyMapping& outMapping)
+{
+	FString name = Unquote(fields.FindRef(TEXT("AxisName")));
+	FString key = Unquote(fields.FindRef(TEXT("Key")));
+	if (!HasMappingKey(name, key))
+	{
+		return false;
+	}
+
+	const FString* scale = fields.Find(TEXT("Scale"));
+	outMapping = FInputAxisKeyMapping(FName(*name), FKey(FName(*key)), scale ? FCString::Atof(**scale) : 1.f);
+	return true;
+}
+
+enum class EMappingLine
+{
+	Kept,
+	Duplicate,
+	Invalid,
+};
+
+//Adds the mapping of a + or plain line to the ones seen so far, or takes it back out for a -
+template<typename MappingType, typename KeyFuncs>
+static EMappingLine TrackMapping(TCHAR op, const TMap<FString, FString>& fields, TSet<MappingType, KeyFuncs>& seen)
+{
+	MappingType mapping;
+	if (!ParseMapping(fields, mapping))
+	{
+		//a - that matches nothing is harmless
+		return op == '-' ? EMappingLine::Kept : EMappingLine::Invalid;
+	}
+
+	if (op == '-')
+	{
+		seen.Remove(mapping);
+		return EMappingLine::Kept;
+	}
+
+	bool bAlreadySeen = false;
+	seen.Add(mapping, &bAlreadySeen);
+	return bAlreadySeen ? EMappingLine::Duplicate : EMappingLine::Kept;
+}
+
+//Keeps DeadZone and Exponent where FAnalogResponseCurve stays finite, by the same rule the
+//plugin applies when it edits them. True if anything changed.
+static bool ClampAxisConfig(TMap<FString, FString>& fields)
+{
+	FString* propertiesText = fields.Find(TEXT("AxisProperties"));
+
+	TMap<FString, FString> properties;
+	if (!propertiesText || !ParseStruct(*propertiesText, properties))
+	{
+		return false;
+	}
+
+	//missing fields keep the engine defaults, which are already in range
+	FString* deadZone = properties.Find(TEXT("DeadZone"));
+	FString* exponent = properties.Find(TEXT("Exponent"));
+
+	FInputAxisProperties clamped;
+	if (deadZone)
+	{
+		clamped.DeadZone = FCString::Atof(**deadZone);
+	}
+	if (exponent)
+	{
+		clamped.Exponent = FCString::Atof(**exponent);
+	}
+
+	FInputAxisProperties original = clamped;
+	if (!FAnalogResponseCurve::ClampProperties(clamped))
+	{
+		return false;
+	}
+
+	if (deadZone && clamped.DeadZone != original.DeadZone)
+	{
+		*deadZone = FString::Printf(TEXT("%f"), clamped.DeadZone);
+	}
+	if (exponent && clamped.Exponent != original.Exponent)
+	{
+		*exponent = FString::Printf(TEXT("%f"), clamped.Exponent);
+	}
+
+	*propertiesText = WriteStruct(properties);
+
+	return true;
+}
+
+static void ParseLines(const FString& text, TArray<FLintSection>& outSections, FConfigLintResult& result)
+{
+	TArray<FString> lines;
+	text.ParseIntoArrayLines(lines);
+
+	TMap<FString, int32> sectionIndices;
+	int32 current = INDEX_NONE;
+
+	for (FString& line : lines)
+	{
+		FString trimmed = line.Trim().TrimTrailing();
+		if (trimmed.IsEmpty())
+		{
+			continue;
+		}
+
+		if (trimmed[0] == '[' && trimmed[trimmed.Len() - 1] == ']')
+		{
+			FString name = trimmed.Mid(1, trimmed.Len() - 2);
+
+			//the engine merges repeated sections when it reads the file
+			int32* existing = sectionIndices.Find(name);
+			if (existing)
+			{
+				current = *existing;
+				result.MergedSections++;
+			}
+			else
+			{
+				current = outSections.AddDefaulted();
+				outSections[current].Name = name;
+				sectionIndices.Add(name, current);
+			}
+			continue;
+		}
+
+		//lines before the first section are ignored by the engine but kept here
+		if (current == INDEX_NONE)
+		{
+			current = outSections.AddDefaulted();
+		}
+
+		FLintLine& entry = outSections[current].Lines[outSections[current].Lines.AddDefaulted()];
+		entry.Raw = trimmed;
+
+		int32 equals;
+		if (trimmed[0] == ';' || !trimmed.FindChar('=', equals))
+		{
+			continue;
+		}
+
+		entry.Key = trimmed.Left(equals).TrimTrailing();
+		entry.Value = trimmed.Mid(equals + 1).Trim();
+
+		if (entry.Key.Len() > 1 && FCString::Strchr(TEXT("+-.!"), entry.Key[0]))
+		{
+			entry.Op = entry.Key[0];
+			entry.Key = entry.Key.Mid(1);
+		}
+	}
+}
+
+static void LintSection(FLintSection& section, FConfigLintResult& result)
+{
+	bool bInput = section.Name == InputSettingsSection;
+	bool bCVars = IsCVarSection(section.Name);
+
+	//the last AxisConfig line of each key, which is the one UPlayerInput ends up with
+	TMap<FString, int32> lastAxisConfigs;
+	if (bInput)
+	{
+		for (int32 i = 0; i < section.Lines.Num(); i++)
+		{
+			const FLintLine& line = section.Lines[i];
+
+			TMap<FString, FString> fields;
+			if ((line.Op == 0 || line.Op == '+') && line.Key == AxisConfigKey && ParseStruct(line.Value, fields))
+			{
+				lastAxisConfigs.Add(Unquote(fields.FindRef(TEXT("AxisKeyName"))), i);
+			}
+		}
+	}
+
+	TSet<FInputActionKeyMapping, FActionMappingKeyFuncs> seenActions;
+	TSet<FInputAxisKeyMapping, FAxisMappingKeyFuncs> seenAxes;
+	TSet<FString> seenLines;
+	TMap<FString, FString> scalarValues;
+
+	for (int32 i = 0; i < section.Lines.Num(); i++)
+	{
+		FLintLine& line = section.Lines[i];
+		if (line.Key.IsEmpty())
+		{
+			continue;
+		}
+
+		bool bArrayKey = line.Key == ActionMappingsKey || line.Key == AxisMappingsKey || line.Key == AxisConfigKey;
+
+		//! empties the array, so whatever was added before it may be added again
+		if (line.Op == '!')
+		{
+			FString prefix = line.Key + TEXT("=");
+			for (auto it = seenLines.CreateIterator(); it; ++it)
+			{
+				if (it->StartsWith(prefix, ESearchCase::CaseSensitive))
+				{
+					it.RemoveCurrent();
+				}
+			}
+
+			if (bInput && line.Key == ActionMappingsKey)
+			{
+				seenActions.Empty();
+			}
+			else if (bInput && line.Key == AxisMappingsKey)
+			{
+				seenAxes.Empty();
+			}
+			continue;
+		}
+
+		if (bInput && bArrayKey && line.Op != '.')
+		{
+			TMap<FString, FString> fields;
+			if (!ParseStruct(line.Value, fields))
+			{
+				result.UnparsedEntries++;
+				continue;
+			}
+
+			if (line.Key == AxisConfigKey)
+			{
+				if (line.Op == '-')
+				{
+					continue;
+				}
+
+				FString axisKey = Unquote(fields.FindRef(TEXT("AxisKeyName")));
+				if (axisKey.IsEmpty() || axisKey == TEXT("None"))
+				{
+					result.InvalidMappings++;
+					line.bRemoved = true;
+				}
+				else if (lastAxisConfigs.FindRef(axisKey) != i)
+				{
+					result.DuplicateAxisConfigs++;
+					line.bRemoved = true;
+				}
+				else if (ClampAxisConfig(fields))
+				{
+					result.ClampedValues++;
+					line.Value = WriteStruct(fields);
+				}
+				continue;
+			}
+
+			EMappingLine state = line.Key == ActionMappingsKey
+				? TrackMapping(line.Op, fields, seenActions)
+				: TrackMapping(line.Op, fields, seenAxes);
+
+			if (state == EMappingLine::Invalid)
+			{
+				result.InvalidMappings++;
+				line.bRemoved = true;
+			}
+			else if (state == EMappingLine::Duplicate)
+			{
+				result.DuplicateMappings++;
+				line.bRemoved = true;
+			}
+			continue;
+		}
+
+		if (line.Op == 0)
+		{
+			//only these sections are known to hold single values; elsewhere repeated plain keys can be arrays
+			if (!bCVars)
+			{
+				continue;
+			}
+
+			const FGraphicsSettingDescriptor* desc = FindDescriptor(line.Key);
+			if (desc)
+			{
+				if (!line.Value.IsNumeric())
+				{
+					result.UnparsedEntries++;
+				}
+				else
+				{
+					int32 value = FCString::Atoi(*line.Value);
+					if (desc->Clamp(value) != value)
+					{
+						line.Value = FString::FromInt(desc->Clamp(value));
+						result.ClampedValues++;
+					}
+				}
+			}
+
+			const FString* previous = scalarValues.Find(line.Key);
+			if (!previous)
+			{
+				scalarValues.Add(line.Key, line.Value);
+			}
+			else if (previous->Equals(line.Value, ESearchCase::CaseSensitive))
+			{
+				result.DuplicateKeys++;
+				line.bRemoved = true;
+			}
+			else
+			{
+				//which one wins depends on how the engine loads the file, so leave the choice to a person
+				result.ConflictingKeys++;
+			}
+			continue;
+		}
+
+		//+ adds a line only if it isn't there yet, so a repeat does nothing until a - takes the line out
+		//again. - removes a single match and . adds duplicates on purpose, so neither is a repeat.
+		FString lineKey = line.Key + TEXT("=") + line.Value;
+		if (line.Op == '+')
+		{
+			bool bAlreadySeen = false;
+			seenLines.Add(lineKey, &bAlreadySeen);
+			if (bAlreadySeen)
+			{
+				result.DuplicateKeys++;
+				line.bRemoved = true;
+			}
+		}
+		else if (line.Op == '-')
+		{
+			seenLines.Remove(lineKey);
+		}
+	}
+}
+
+FConfigLintResult FConfigLint::Lint(const FString& text, FString& outText)
+{
+	FConfigLintResult result;
+
+	TArray<FLintSection> sections;
+	ParseLines(text, sections, result);
+
+	outText.Empty(text.Len());
+
+	for (FLintSection& section : sections)
+	{
+		LintSection(section, result);
+
+		bool bEmpty = true;
+		for (const FLintLine& line : section.Lines)
+		{
+			bEmpty &= line.bRemoved;
+		}
+
+		if (bEmpty)
+		{
+			continue;
+		}
+
+		if (!section.Name.IsEmpty())
+		{
+			if (outText.Len() > 0)
+			{
+				outText += LINE_TERMINATOR;
+			}
+
+			outText += TEXT("[") + section.Name + TEXT("]") LINE_TERMINATOR;
+		}
+
+		for (const FLintLine& line : section.Lines)
+		{
+			if (line.bRemoved)
+			{
+				continue;
+			}
+
+			if (line.Key.IsEmpty())
+			{
+				outText += line.Raw;
+			}
+			else
+			{
+				if (line.Op)
+				{
+					outText.AppendChar(line.Op);
+				}
+
+				outText += line.Key + TEXT("=") + line.Value;
+			}
+
+			outText += LINE_TERMINATOR;
+		}
+	}
+
+	return result;
+}
@@ -0,0 +1,51 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+struct FConfigLintResult
+{
+	//entries removed or rewritten
+	int32 DuplicateMappings;
+	int32 DuplicateAxisConfigs;
+	int32 DuplicateKeys;
+	int32 InvalidMappings;
+	int32 ClampedValues;
+	int32 MergedSections;
+
+	//reported but left alone
+	int32 ConflictingKeys;
+	int32 UnparsedEntries;
+
+	FConfigLintResult()
+		: DuplicateMappings(0), DuplicateAxisConfigs(0), DuplicateKeys(0), InvalidMappings(0), ClampedValues(0)
+		, MergedSections(0), ConflictingKeys(0), UnparsedEntries(0)
+	{}
+
+	int32 GetFixCount() const
+	{
+		return DuplicateMappings + DuplicateAxisConfigs + DuplicateKeys + InvalidMappings + ClampedValues + MergedSections;
+	}
+
+	int32 GetProblemCount() const
+	{
+		return GetFixCount() + ConflictingKeys + UnparsedEntries;
+	}
+
+	void Accumulate(const FConfigLintResult& other);
+};
+
+/**
+ * Validates and compacts the text of a saved Engine, GameUserSettings or Input ini with the rules
+ * the plugin applies when it edits them: action and axis mappings are unique by the operator== the
+ * engine uses, AxisConfig holds one entry per key (the last one, as UPlayerInput keeps), and
+ * the console variables of GraphicsSettingDescriptors stay within their ranges. Repeated section
+ * headers are merged and empty sections dropped.
+ *
+ * Works on text only and touches neither GConfig nor UObjects, so files can be linted in parallel.
+ */
+class FConfigLint
+{
+public:
+
+	static FConfigLintResult Lint(const FString& text, FString& outText);
+};
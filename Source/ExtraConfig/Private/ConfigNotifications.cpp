@@ -0,0 +1,114 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ExtraConfigPrivatePCH.h"
+#include "ConfigNotifications.h"
+
+FOnConfigChangedNative UConfigNotifications::OnConfigChangedNative;
+
+static UConfigNotifications* Instance = nullptr;
+
+//Changes since the last broadcast, and the ticker that will send them
+static int32 PendingConfig = 0;
+static int32 PendingGraphicsSettings = 0;
+static FDelegateHandle TickerHandle;
+
+UConfigNotifications::UConfigNotifications(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
+{
+
+}
+
+UConfigNotifications* UConfigNotifications::GetConfigNotifications()
+{
+	if (!Instance)
+	{
+		Instance = NewObject<UConfigNotifications>();
+		Instance->AddToRoot();
+	}
+
+	return Instance;
+}
+
+bool UConfigNotifications::HasConfigChange(int32 changedConfig, EConfigChange change)
+{
+	return (changedConfig & (1 << (int32)change)) != 0;
+}
+
+bool UConfigNotifications::HasGraphicsSettingChange(int32 changedGraphicsSettings, EGraphicsSetting setting)
+{
+	return (changedGraphicsSettings & (1 << (int32)setting)) != 0;
+}
+
+void UConfigNotifications::MarkChanged(int32 changedConfig, int32 changedGraphicsSettings)
+{
+	if (changedConfig == 0 && changedGraphicsSettings == 0)
+	{
+		return;
+	}
+
+	PendingConfig |= changedConfig;
+	PendingGraphicsSettings |= changedGraphicsSettings;
+
+	if (!TickerHandle.IsValid())
+	{
+		TickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateStatic(&UConfigNotifications::TickNotifications));
+	}
+}
+
+void UConfigNotifications::MarkChanged(EConfigChange change)
+{
+	MarkChanged(1 << (int32)change, 0);
+}
+
+bool UConfigNotifications::TickNotifications(float deltaTime)
+{
+	TickerHandle.Reset();
+
+	FlushNotifications();
+
+	//one shot; the next change registers again
+	return false;
+}
+
+void UConfigNotifications::FlushNotifications()
+{
+	if (TickerHandle.IsValid())
+	{
+		FTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+		TickerHandle.Reset();
+	}
+
+	int32 changedConfig = PendingConfig;
+	int32 changedGraphicsSettings = PendingGraphicsSettings;
+
+	if (changedConfig == 0 && changedGraphicsSettings == 0)
+	{
+		return;
+	}
+
+	//cleared first so listeners that change settings are picked up by the next broadcast
+	PendingConfig = 0;
+	PendingGraphicsSettings = 0;
+
+	OnConfigChangedNative.Broadcast(changedConfig, changedGraphicsSettings);
+
+	if (Instance)
+	{
+		Instance->OnConfigChanged.Broadcast(changedConfig, changedGraphicsSettings);
+	}
+}
+
+void UConfigNotifications::Shutdown()
+{
+	if (TickerHandle.IsValid())
+	{
+		FTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+		TickerHandle.Reset();
+	}
+
+	PendingConfig = 0;
+	PendingGraphicsSettings = 0;
+	OnConfigChangedNative.Clear();
+
+	//the object itself is torn down with the rest of UObject at exit
+	Instance = nullptr;
+}
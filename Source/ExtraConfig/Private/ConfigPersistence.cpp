@@ -0,0 +1,365 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ExtraConfigPrivatePCH.h"
+#include "ConfigPersistence.h"
+#include "ConfigDelta.h"
+
+FConfigPersistence* FConfigPersistence::Instance = nullptr;
+
+//FConfigFile's copy constructor copies the SourceConfigFile pointer, which both copies then delete,
+//so only the values are copied. Write rebuilds the source file from the hierarchy if it needs one.
+static void SnapshotConfigFile(const FConfigFile& file, FConfigFile& outSnapshot)
+{
+	for (const auto& section : file)
+	{
+		outSnapshot.Add(section.Key, section.Value);
+	}
+
+	outSnapshot.Name = file.Name;
+	outSnapshot.SourceIniHierarchy = file.SourceIniHierarchy;
+
+	//Write skips a file that isn't dirty, and the snapshot is only taken to be written
+	outSnapshot.Dirty = true;
+	outSnapshot.NoSave = file.NoSave;
+}
+
+FConfigPersistence::FConfigPersistence()
+	: Thread(nullptr)
+{
+	WakeEvent = FPlatformProcess::CreateSynchEvent(false);
+	Thread = FRunnableThread::Create(this, TEXT("ExtraConfigPersistence"), 0, TPri_BelowNormal);
+}
+
+FConfigPersistence::~FConfigPersistence()
+{
+	if (Thread)
+	{
+		Thread->Kill(true);
+		delete Thread;
+		Thread = nullptr;
+	}
+
+	delete WakeEvent;
+	WakeEvent = nullptr;
+}
+
+void FConfigPersistence::Startup()
+{
+	if (!Instance)
+	{
+		Instance = new FConfigPersistence();
+	}
+}
+
+void FConfigPersistence::Shutdown()
+{
+	if (Instance)
+	{
+		FlushPendingWrites();
+
+		delete Instance;
+		Instance = nullptr;
+	}
+}
+
+void FConfigPersistence::QueueWrite(const FString& filename)
+{
+	FConfigFile* file = GConfig->Find(filename, false);
+	if (!file || !file->Dirty || file->NoSave)
+	{
+		return;
+	}
+
+	//no worker (module not started up, or already shut down), write in place
+	if (!Instance)
+	{
+		INC_DWORD_STAT(STAT_ExtraConfig_ConfigFlushes);
+		GConfig->Flush(false, filename);
+		return;
+	}
+
+	INC_DWORD_STAT(STAT_ExtraConfig_ConfigFlushes);
+
+	Instance->Enqueue(filename, *file);
+
+	//the snapshot owns these changes now; NotifyWritten marks the file dirty again if the write fails
+	file->Dirty = false;
+}
+
+void FConfigPersistence::FlushPendingWrites()
+{
+	if (Instance)
+	{
+		Instance->WritePending();
+	}
+}
+
+void FConfigPersistence::WhenWritten(TFunction<void()> onWritten)
+{
+	check(IsInGameThread());
+
+	int32 generation = Instance ? Instance->QueuedGeneration.GetValue() : 0;
+	if (!Instance || Instance->WrittenGeneration.GetValue() >= generation)
+	{
+		onWritten();
+		return;
+	}
+
+	FWrittenCallback entry;
+	entry.Generation = generation;
+	entry.Callback = onWritten;
+	Instance->WrittenCallbacks.Add(entry);
+}
+
+void FConfigPersistence::NotifyWritten(int32 generation, const TArray<FString>& failedFiles)
+{
+	//GConfig still holds the values, so the next QueueWrite or the engine's flush at exit tries again
+	for (const FString& filename : failedFiles)
+	{
+		FConfigFile* file = GConfig ? GConfig->Find(filename, false) : nullptr;
+		if (file)
+		{
+			file->Dirty = true;
+		}
+	}
+
+	if (!Instance)
+	{
+		return;
+	}
+
+	TArray<TFunction<void()>> ready;
+	for (int32 i = Instance->WrittenCallbacks.Num() - 1; i >= 0; i--)
+	{
+		if (Instance->WrittenCallbacks[i].Generation <= generation)
+		{
+			ready.Insert(Instance->WrittenCallbacks[i].Callback, 0);
+			Instance->WrittenCallbacks.RemoveAt(i);
+		}
+	}
+
+	for (const TFunction<void()>& callback : ready)
+	{
+		callback();
+	}
+}
+
+void FConfigPersistence::Enqueue(const FString& filename, const FConfigFile& snapshot)
+{
+	FPendingWrite write;
+	SnapshotConfigFile(snapshot, write.Snapshot);
+	write.Defaults = GetDeltaDefaults(filename);
+
+	{
+		FScopeLock scope(&QueueLock);
+		//replaces any older snapshot of the same file that hasn't been written yet
+		Pending.Add(filename, write);
+		QueuedGeneration.Increment();
+	}
+
+	WakeEvent->Trigger();
+}
+
+void FConfigPersistence::WritePending()
+{
+	FScopeLock writeScope(&WriteLock);
+
+	TMap<FString, FPendingWrite> batch;
+	int32 generation;
+	{
+		FScopeLock queueScope(&QueueLock);
+		Exchange(batch, Pending);
+		generation = QueuedGeneration.GetValue();
+	}
+
+	TArray<FString> failedFiles;
+	for (auto& entry : batch)
+	{
+		if (!WriteFile(entry.Key, entry.Value))
+		{
+			failedFiles.Add(entry.Key);
+		}
+	}
+
+	WrittenGeneration.Set(generation);
+
+	if (IsInGameThread())
+	{
+		NotifyWritten(generation, failedFiles);
+	}
+	else
+	{
+		FFunctionGraphTask::CreateAndDispatchWhenReady([generation, failedFiles]()
+		{
+			NotifyWritten(generation, failedFiles);
+		}, TStatId(), nullptr, ENamedThreads::GameThread);
+	}
+}
+
+bool FConfigPersistence::WriteFile(const FString& filename, const FPendingWrite& write)
+{
+	FString tempFilename = filename + TEXT(".tmp");
+	double start = FPlatformTime::Seconds();
+
+	bool bWritten = write.Defaults.IsValid()
+		? FFileHelper::SaveStringToFile(FConfigDelta::MakeDeltaText(*write.Defaults, write.Snapshot), *tempFilename)
+		: write.Snapshot.Write(tempFilename);
+
+	if (!bWritten)
+	{
+		UE_LOG(LogExtraConfig, Warning, TEXT("Failed to write %s"), *tempFilename);
+		return false;
+	}
+
+	if (!IFileManager::Get().Move(*filename, *tempFilename, true, true))
+	{
+		UE_LOG(LogExtraConfig, Warning, TEXT("Failed to replace %s"), *filename);
+		IFileManager::Get().Delete(*tempFilename);
+		return false;
+	}
+
+	int64 bytes = IFileManager::Get().FileSize(*filename);
+
+	INC_DWORD_STAT(STAT_ExtraConfig_FilesWritten);
+	INC_DWORD_STAT_BY(STAT_ExtraConfig_BytesWritten, (uint32)FMath::Max<int64>(bytes, 0));
+
+	UE_LOG(LogExtraConfig, Verbose, TEXT("Wrote %s: %lld bytes in %.2f ms"), *filename, bytes, (FPlatformTime::Seconds() - start) * 1000.0);
+
+	return true;
+}
+
+static double TimeParse(const FString& filename)
+{
+	double start = FPlatformTime::Seconds();
+
+	FConfigFile file;
+	file.Read(filename);
+
+	return FPlatformTime::Seconds() - start;
+}
+
+TSharedPtr<const FConfigFile, ESPMode::ThreadSafe> FConfigPersistence::GetDeltaDefaults(const FString& filename)
+{
+	FDeltaSource* source = DeltaSources.Find(filename);
+	if (!source)
+	{
+		return nullptr;
+	}
+
+	if (!source->Defaults.IsValid())
+	{
+		TSharedPtr<FConfigFile, ESPMode::ThreadSafe> defaults = MakeShareable(new FConfigFile());
+		if (!FConfigDelta::LoadDefaults(source->BaseIniName, *defaults))
+		{
+			UE_LOG(LogExtraConfig, Warning, TEXT("No defaults found for %s, writing it in full"), *source->BaseIniName);
+			DeltaSources.Remove(filename);
+			return nullptr;
+		}
+
+		source->Defaults = defaults;
+	}
+
+	return source->Defaults;
+}
+
+void FConfigPersistence::EnableDeltaWrites(const FString& filename, const FString& baseIniName, bool bMigrate)
+{
+	if (!Instance)
+	{
+		return;
+	}
+
+	FDeltaSource source;
+	source.BaseIniName = baseIniName;
+	Instance->DeltaSources.Add(filename, source);
+
+	if (!bMigrate)
+	{
+		return;
+	}
+
+	TSharedPtr<const FConfigFile, ESPMode::ThreadSafe> defaults = Instance->GetDeltaDefaults(filename);
+	if (!defaults.IsValid())
+	{
+		return;
+	}
+
+	//migration: shrink a file that still holds values equal to the defaults
+	FConfigFile* file = GConfig->Find(filename, false);
+	int64 oldSize = IFileManager::Get().FileSize(*filename);
+	if (!file || file->NoSave || oldSize <= 0)
+	{
+		return;
+	}
+
+	FString delta = FConfigDelta::MakeDeltaText(*defaults, *file);
+	if (delta.Len() >= oldSize)
+	{
+		return;
+	}
+
+	double oldParse = TimeParse(filename);
+
+	//anything already queued for the file is older than what GConfig holds now
+	{
+		FScopeLock writeScope(&Instance->WriteLock);
+		{
+			FScopeLock queueScope(&Instance->QueueLock);
+			Instance->Pending.Remove(filename);
+		}
+
+		FPendingWrite write;
+		SnapshotConfigFile(*file, write.Snapshot);
+		write.Defaults = defaults;
+
+		if (!WriteFile(filename, write))
+		{
+			return;
+		}
+	}
+
+	file->Dirty = false;
+
+	UE_LOG(LogExtraConfig, Log, TEXT("Migrated %s to defaults delta: %lld -> %lld bytes, parse %.2f -> %.2f ms"),
+		*filename, oldSize, IFileManager::Get().FileSize(*filename), oldParse * 1000.0, TimeParse(filename) * 1000.0);
+}
+
+uint32 FConfigPersistence::Run()
+{
+	while (StopRequested.GetValue() == 0)
+	{
+		WakeEvent->Wait();
+		WritePending();
+	}
+
+	return 0;
+}
+
+void FConfigPersistence::Stop()
+{
+	StopRequested.Increment();
+	WakeEvent->Trigger();
+}
+
+FScopedDeferredConfigWrite::FScopedDeferredConfigWrite(const FString& filename)
+	: Filename(filename)
+	, bWasNoSave(false)
+{
+	FConfigFile* file = GConfig->Find(Filename, false);
+	if (file)
+	{
+		bWasNoSave = file->NoSave;
+		file->NoSave = true;
+	}
+}
+
+FScopedDeferredConfigWrite::~FScopedDeferredConfigWrite()
+{
+	FConfigFile* file = GConfig->Find(Filename, false);
+	if (file)
+	{
+		file->NoSave = bWasNoSave;
+	}
+
+	FConfigPersistence::QueueWrite(Filename);
+}
@@ -0,0 +1,112 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "Runtime/Core/Public/Misc/ConfigCacheIni.h"
+
+/**
+ * Writes config files to disk on a worker thread.
+ *
+ * QueueWrite snapshots a file out of GConfig on the calling thread. The worker serializes the
+ * snapshot to a temp file and renames it over the real one, so a crash mid-write never leaves a
+ * truncated ini behind. Writes of the same file that are still queued are merged, so only the
+ * latest snapshot reaches disk.
+ */
+class FConfigPersistence : public FRunnable
+{
+public:
+
+	static void Startup();
+	static void Shutdown();
+
+	/** Snapshots the file out of GConfig if it is dirty and queues it for writing. */
+	static void QueueWrite(const FString& filename);
+
+	/** Blocks until every queued write has reached disk. */
+	static void FlushPendingWrites();
+
+	/** Calls onWritten on the game thread once everything queued so far has reached disk; right away if nothing is pending. */
+	static void WhenWritten(TFunction<void()> onWritten);
+
+	/**
+	 * From now on, writes the file as a delta against the shipped defaults of baseIniName
+	 * (e.g. "Input"). The defaults are loaded on the first write unless bMigrate is set, which
+	 * loads them now and rewrites the file on disk if the delta is smaller, shrinking saved
+	 * files written in full by the engine or older versions. Game thread only.
+	 */
+	static void EnableDeltaWrites(const FString& filename, const FString& baseIniName, bool bMigrate);
+
+	//FRunnable
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+
+	virtual ~FConfigPersistence();
+
+private:
+
+	FConfigPersistence();
+
+	struct FPendingWrite
+	{
+		FConfigFile Snapshot;
+		TSharedPtr<const FConfigFile, ESPMode::ThreadSafe> Defaults;
+	};
+
+	void Enqueue(const FString& filename, const FConfigFile& snapshot);
+	void WritePending();
+
+	static bool WriteFile(const FString& filename, const FPendingWrite& write);
+	static void NotifyWritten(int32 generation, const TArray<FString>& failedFiles);
+
+	static FConfigPersistence* Instance;
+
+	FRunnableThread* Thread;
+	FEvent* WakeEvent;
+	FThreadSafeCounter StopRequested;
+
+	//guards Pending
+	FCriticalSection QueueLock;
+	//held for the whole of a write pass, so FlushPendingWrites can wait out the worker
+	FCriticalSection WriteLock;
+
+	TMap<FString, FPendingWrite> Pending;
+
+	//bumped by every Enqueue, and set to the queued count a write pass started from once it is done
+	FThreadSafeCounter QueuedGeneration;
+	FThreadSafeCounter WrittenGeneration;
+
+	//WhenWritten callbacks with the generation they wait for; only touched on the game thread
+	struct FWrittenCallback
+	{
+		int32 Generation;
+		TFunction<void()> Callback;
+	};
+
+	TArray<FWrittenCallback> WrittenCallbacks;
+
+	//files written as deltas, with their shipped defaults once loaded; only touched on the game thread
+	struct FDeltaSource
+	{
+		FString BaseIniName;
+		TSharedPtr<const FConfigFile, ESPMode::ThreadSafe> Defaults;
+	};
+
+	TMap<FString, FDeltaSource> DeltaSources;
+
+	TSharedPtr<const FConfigFile, ESPMode::ThreadSafe> GetDeltaDefaults(const FString& filename);
+};
+
+/**
+ * Suppresses disk writes of a config file while in scope, then queues one asynchronous write.
+ * Wrap engine calls that flush internally, such as UObject::SaveConfig or UGameUserSettings::SaveSettings.
+ */
+struct FScopedDeferredConfigWrite
+{
+	FScopedDeferredConfigWrite(const FString& filename);
+	~FScopedDeferredConfigWrite();
+
+private:
+
+	FString Filename;
+	bool bWasNoSave;
+};
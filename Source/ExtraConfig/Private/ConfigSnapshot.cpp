@@ -0,0 +1,196 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ExtraConfigPrivatePCH.h"
+#include "ConfigSnapshot.h"
+#include "ConfigBackend.h"
+#include "GameFramework/GameUserSettings.h"
+
+//The published snapshot. The slot itself holds one reference.
+static FConfigSnapshot* volatile CurrentSnapshot = nullptr;
+
+//Readers count themselves in their epoch's counter from before they load CurrentSnapshot until
+//they hold their reference. A snapshot swapped out of the slot keeps the slot's reference until
+//the counter of the epoch it was retired in has drained, so Publish never waits for readers.
+static FThreadSafeCounter ReaderEpoch;
+static FThreadSafeCounter ActiveReaders[2];
+
+//Game thread only: snapshots swapped out since the last epoch flip, and those waiting for the
+//readers of DrainingEpoch to finish
+static TArray<FConfigSnapshot*> RetiredSnapshots;
+static TArray<FConfigSnapshot*> DrainingSnapshots;
+static int32 DrainingEpoch = 0;
+static FDelegateHandle ReclaimTickerHandle;
+
+static int32 NextGeneration = 1;
+
+//Snapshots not yet freed, for leak checks
+static FThreadSafeCounter LiveSnapshots;
+
+FConfigSnapshot::FConfigSnapshot()
+	: Resolution(0, 0)
+	, ScreenMode(EScreenMode::Window)
+	, Generation(0)
+{
+	LiveSnapshots.Increment();
+}
+
+void FConfigSnapshot::AddRef() const
+{
+	RefCount.Increment();
+}
+
+void FConfigSnapshot::Release() const
+{
+	if (RefCount.Decrement() == 0)
+	{
+		LiveSnapshots.Decrement();
+		delete this;
+	}
+}
+
+FConfigSnapshotRef FConfigSnapshot::Acquire()
+{
+	if (!CurrentSnapshot && IsInGameThread())
+	{
+		PublishCurrent();
+	}
+
+	//register in the current epoch; if it flipped in between, the writer may already have
+	//stopped watching the counter we picked, so try again
+	int32 epoch;
+	for (;;)
+	{
+		epoch = ReaderEpoch.GetValue();
+		ActiveReaders[epoch & 1].Increment();
+
+		if (ReaderEpoch.GetValue() == epoch)
+		{
+			break;
+		}
+
+		ActiveReaders[epoch & 1].Decrement();
+	}
+
+	FConfigSnapshot* snapshot = (FConfigSnapshot*)FPlatformAtomics::InterlockedCompareExchangePointer((void**)&CurrentSnapshot, nullptr, nullptr);
+	if (snapshot)
+	{
+		snapshot->AddRef();
+	}
+
+	ActiveReaders[epoch & 1].Decrement();
+
+	return FConfigSnapshotRef(snapshot);
+}
+
+void FConfigSnapshot::ReleaseAll(TArray<FConfigSnapshot*>& snapshots)
+{
+	for (FConfigSnapshot* snapshot : snapshots)
+	{
+		snapshot->Release();
+	}
+
+	snapshots.Reset();
+}
+
+bool FConfigSnapshot::Reclaim(float deltaTime)
+{
+	check(IsInGameThread());
+
+	if (DrainingSnapshots.Num() > 0 && ActiveReaders[DrainingEpoch & 1].GetValue() == 0)
+	{
+		ReleaseAll(DrainingSnapshots);
+	}
+
+	if (DrainingSnapshots.Num() == 0 && RetiredSnapshots.Num() > 0)
+	{
+		//readers registering from now on load a pointer published after every retired one
+		DrainingEpoch = ReaderEpoch.Increment() - 1;
+		Swap(DrainingSnapshots, RetiredSnapshots);
+
+		if (ActiveReaders[DrainingEpoch & 1].GetValue() == 0)
+		{
+			ReleaseAll(DrainingSnapshots);
+		}
+	}
+
+	bool bPending = DrainingSnapshots.Num() > 0 || RetiredSnapshots.Num() > 0;
+	if (!bPending)
+	{
+		ReclaimTickerHandle.Reset();
+	}
+	else if (!ReclaimTickerHandle.IsValid())
+	{
+		ReclaimTickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateStatic(&FConfigSnapshot::Reclaim));
+	}
+
+	return bPending;
+}
+
+void FConfigSnapshot::PublishCurrent()
+{
+	FConfigSnapshot* snapshot = new FConfigSnapshot();
+
+	snapshot->Graphics = UGraphicsConfig::GetGraphicsSettings();
+
+	if (GEngine && GEngine->GameUserSettings)
+	{
+		FInt2D res = UGraphicsConfig::GetCurrentResolution();
+		snapshot->Resolution = FIntPoint(res.X, res.Y);
+		snapshot->ScreenMode = UGraphicsConfig::GetScreenMode();
+	}
+
+	UInputSettings* Settings = IConfigBackend::Get().GetInputSettings();
+	if (Settings)
+	{
+		snapshot->ActionMappings = Settings->ActionMappings;
+		snapshot->AxisMappings = Settings->AxisMappings;
+		snapshot->AxisConfig = Settings->AxisConfig;
+	}
+
+	Publish(snapshot);
+}
+
+void FConfigSnapshot::Publish(FConfigSnapshot* snapshot)
+{
+	check(IsInGameThread());
+
+	if (snapshot)
+	{
+		snapshot->Generation = NextGeneration++;
+		snapshot->AddRef();
+	}
+
+	FConfigSnapshot* old = (FConfigSnapshot*)FPlatformAtomics::InterlockedExchangePtr((void**)&CurrentSnapshot, snapshot);
+
+	if (old)
+	{
+		RetiredSnapshots.Add(old);
+	}
+
+	Reclaim(0.f);
+}
+
+int32 FConfigSnapshot::GetLiveCount()
+{
+	return LiveSnapshots.GetValue();
+}
+
+void FConfigSnapshot::Shutdown()
+{
+	Publish(nullptr);
+
+	//a second pass drains the epoch the first one flipped to, if no reader is in the middle of an Acquire
+	Reclaim(0.f);
+
+	if (ReclaimTickerHandle.IsValid())
+	{
+		FTicker::GetCoreTicker().RemoveTicker(ReclaimTickerHandle);
+		ReclaimTickerHandle.Reset();
+	}
+
+	if (DrainingSnapshots.Num() > 0 || RetiredSnapshots.Num() > 0)
+	{
+		UE_LOG(LogExtraConfig, Verbose, TEXT("%d config snapshots still being acquired at shutdown are left to process exit"),
+			DrainingSnapshots.Num() + RetiredSnapshots.Num());
+	}
+}
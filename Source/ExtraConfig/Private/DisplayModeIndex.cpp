@@ -0,0 +1,278 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ExtraConfigPrivatePCH.h"
+#include "DisplayModeIndex.h"
+#include "Runtime/Slate/Public/Framework/Application/SlateApplication.h"
+
+static bool GetRHIResolutions(FScreenResolutionArray& resolutions)
+{
+	return RHIGetAvailableResolutions(resolutions, true);
+}
+
+FDisplayModeIndex::FDisplayModeIndex()
+	: Provider(&GetRHIResolutions)
+	, bBuilt(false)
+	, Generation(0)
+	, bEnumerating(false)
+{
+}
+
+FDisplayModeIndex& FDisplayModeIndex::Get()
+{
+	static FDisplayModeIndex Instance;
+	return Instance;
+}
+
+void FDisplayModeIndex::SetProvider(FResolutionProvider provider)
+{
+	Provider = provider ? provider : FResolutionProvider(&GetRHIResolutions);
+	Invalidate();
+}
+
+void FDisplayModeIndex::Invalidate()
+{
+	bBuilt = false;
+	Generation++;
+}
+
+void FDisplayModeIndex::BindDisplayChanges()
+{
+	if (!DisplayMetricsHandle.IsValid() && !BindTickerHandle.IsValid() && !TryBindDisplayChanges(0.f))
+	{
+		//the module can load before Slate is up
+		BindTickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FDisplayModeIndex::TryBindDisplayChanges));
+	}
+}
+
+void FDisplayModeIndex::UnbindDisplayChanges()
+{
+	if (BindTickerHandle.IsValid())
+	{
+		FTicker::GetCoreTicker().RemoveTicker(BindTickerHandle);
+		BindTickerHandle.Reset();
+	}
+
+	if (DisplayMetricsHandle.IsValid() && FSlateApplication::IsInitialized())
+	{
+		FSlateApplication::Get().GetPlatformApplication()->OnDisplayMetricsChanged().Remove(DisplayMetricsHandle);
+	}
+
+	DisplayMetricsHandle.Reset();
+}
+
+bool FDisplayModeIndex::TryBindDisplayChanges(float deltaTime)
+{
+	if (!FSlateApplication::IsInitialized() || !FSlateApplication::Get().GetPlatformApplication().IsValid())
+	{
+		return true;
+	}
+
+	DisplayMetricsHandle = FSlateApplication::Get().GetPlatformApplication()->OnDisplayMetricsChanged().AddRaw(this, &FDisplayModeIndex::OnDisplayMetricsChanged);
+	BindTickerHandle.Reset();
+
+	return false;
+}
+
+void FDisplayModeIndex::OnDisplayMetricsChanged(const FDisplayMetrics& metrics)
+{
+	UE_LOG(LogExtraConfig, Verbose, TEXT("Display metrics changed, rebuilding the display mode list on next use"));
+
+	Invalidate();
+}
+
+int32 FDisplayModeIndex::MakeAspectKey(int32 width, int32 height)
+{
+	return height > 0 ? FMath::RoundToInt(width * 100.f / height) : 0;
+}
+
+void FDisplayModeIndex::ConditionalBuild()
+{
+	if (bBuilt)
+	{
+		return;
+	}
+
+	FScreenResolutionArray resolutions;
+	bool bEnumerated = Provider(resolutions);
+
+	Build(resolutions, bEnumerated);
+}
+
+void FDisplayModeIndex::Build(FScreenResolutionArray& resolutions, bool bEnumerated)
+{
+	bBuilt = true;
+	Modes.Reset();
+	ModesByAspect.Reset();
+
+	if (!bEnumerated)
+	{
+		return;
+	}
+
+	resolutions.Sort([](const FScreenResolutionRHI& a, const FScreenResolutionRHI& b)
+	{
+		if (a.Width != b.Width) return a.Width < b.Width;
+		if (a.Height != b.Height) return a.Height < b.Height;
+		return a.RefreshRate < b.RefreshRate;
+	});
+
+	//one entry per resolution, collecting its refresh rates
+	for (const FScreenResolutionRHI& res : resolutions)
+	{
+		if (Modes.Num() == 0 || Modes.Last().Width != (int32)res.Width || Modes.Last().Height != (int32)res.Height)
+		{
+			FDisplayMode mode;
+			mode.Width = res.Width;
+			mode.Height = res.Height;
+			mode.AspectKey = MakeAspectKey(mode.Width, mode.Height);
+			Modes.Add(mode);
+		}
+
+		TArray<int32>& rates = Modes.Last().RefreshRates;
+		if (rates.Num() == 0 || rates.Last() != (int32)res.RefreshRate)
+		{
+			rates.Add(res.RefreshRate);
+		}
+	}
+
+	for (int32 i = 0; i < Modes.Num(); i++)
+	{
+		ModesByAspect.FindOrAdd(Modes[i].AspectKey).Add(i);
+	}
+}
+
+void FDisplayModeIndex::BuildAsync(TFunction<void()> onReady)
+{
+	check(IsInGameThread());
+
+	if (bBuilt)
+	{
+		onReady();
+		return;
+	}
+
+	ReadyCallbacks.Add(onReady);
+
+	if (!bEnumerating)
+	{
+		StartEnumeration();
+	}
+}
+
+void FDisplayModeIndex::StartEnumeration()
+{
+	bEnumerating = true;
+
+	FResolutionProvider provider = Provider;
+	int32 generation = Generation;
+
+	//the RHI only queries the display adapter here, which doesn't need the game or render thread
+	FFunctionGraphTask::CreateAndDispatchWhenReady([provider, generation]()
+	{
+		FScreenResolutionArray resolutions;
+		bool bEnumerated = provider(resolutions);
+
+		FFunctionGraphTask::CreateAndDispatchWhenReady([resolutions, bEnumerated, generation]() mutable
+		{
+			FDisplayModeIndex::Get().FinishEnumeration(resolutions, bEnumerated, generation);
+		}, TStatId(), nullptr, ENamedThreads::GameThread);
+	}, TStatId(), nullptr, ENamedThreads::AnyThread);
+}
+
+void FDisplayModeIndex::FinishEnumeration(FScreenResolutionArray& resolutions, bool bEnumerated, int32 generation)
+{
+	bEnumerating = false;
+
+	//a synchronous query may have built the index in the meantime
+	if (!bBuilt)
+	{
+		if (generation != Generation)
+		{
+			StartEnumeration();
+			return;
+		}
+
+		Build(resolutions, bEnumerated);
+	}
+
+	TArray<TFunction<void()>> callbacks;
+	Exchange(callbacks, ReadyCallbacks);
+
+	for (const TFunction<void()>& callback : callbacks)
+	{
+		callback();
+	}
+}
+
+const TArray<FDisplayMode>& FDisplayModeIndex::GetModes()
+{
+	ConditionalBuild();
+	return Modes;
+}
+
+const FDisplayMode* FDisplayModeIndex::Find(int32 width, int32 height)
+{
+	ConditionalBuild();
+
+	int32 low = 0;
+	int32 high = Modes.Num();
+	while (low < high)
+	{
+		int32 mid = (low + high) / 2;
+		const FDisplayMode& mode = Modes[mid];
+		if (mode.Width < width || (mode.Width == width && mode.Height < height))
+		{
+			low = mid + 1;
+		}
+		else
+		{
+			high = mid;
+		}
+	}
+
+	if (low < Modes.Num() && Modes[low].Width == width && Modes[low].Height == height)
+	{
+		return &Modes[low];
+	}
+
+	return nullptr;
+}
+
+const FDisplayMode* FDisplayModeIndex::FindLargestAtMost(int32 maxWidth, int32 maxHeight, int32 aspectX, int32 aspectY)
+{
+	ConditionalBuild();
+
+	const TArray<int32>* bucket = ModesByAspect.Find(MakeAspectKey(aspectX, aspectY));
+	if (!bucket)
+	{
+		return nullptr;
+	}
+
+	//first mode wider than maxWidth
+	int32 low = 0;
+	int32 high = bucket->Num();
+	while (low < high)
+	{
+		int32 mid = (low + high) / 2;
+		if (Modes[(*bucket)[mid]].Width <= maxWidth)
+		{
+			low = mid + 1;
+		}
+		else
+		{
+			high = mid;
+		}
+	}
+
+	//within one aspect ratio height grows with width, so this rarely steps more than once
+	for (int32 i = low - 1; i >= 0; i--)
+	{
+		const FDisplayMode& mode = Modes[(*bucket)[i]];
+		if (mode.Height <= maxHeight)
+		{
+			return &mode;
+		}
+	}
+
+	return nullptr;
+}
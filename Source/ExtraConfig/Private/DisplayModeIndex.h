@@ -0,0 +1,84 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "RHI.h"
+
+struct FDisplayMode
+{
+	int32 Width;
+	int32 Height;
+	int32 AspectKey;
+	//ascending, no duplicates
+	TArray<int32> RefreshRates;
+};
+
+/**
+ * Sorted, deduplicated list of fullscreen display modes, built once from the RHI and kept until
+ * Invalidate is called on a display change. Modes are ordered by width then height and also
+ * bucketed by aspect ratio, so lookups are binary searches rather than scans of the RHI list.
+ */
+class FDisplayModeIndex
+{
+public:
+
+	typedef TFunction<bool(FScreenResolutionArray&)> FResolutionProvider;
+
+	static FDisplayModeIndex& Get();
+
+	/** Replaces RHIGetAvailableResolutions, e.g. with a fixed list when there is no GPU. Pass nullptr to restore. */
+	void SetProvider(FResolutionProvider provider);
+
+	void Invalidate();
+
+	/**
+	 * Invalidates the index whenever the platform reports a display being connected, removed or
+	 * changing mode. Binds as soon as the Slate application exists.
+	 */
+	void BindDisplayChanges();
+	void UnbindDisplayChanges();
+
+	/**
+	 * Calls onReady on the game thread once the modes are available. If they still have to be
+	 * enumerated, the provider runs on a worker thread so the game thread keeps ticking.
+	 */
+	void BuildAsync(TFunction<void()> onReady);
+
+	const TArray<FDisplayMode>& GetModes();
+
+	const FDisplayMode* Find(int32 width, int32 height);
+
+	/** Largest mode of the given aspect ratio that fits inside maxWidth x maxHeight. */
+	const FDisplayMode* FindLargestAtMost(int32 maxWidth, int32 maxHeight, int32 aspectX, int32 aspectY);
+
+	/** Aspect ratio rounded to two decimals, so 1366x768 and 1920x1080 share a bucket. */
+	static int32 MakeAspectKey(int32 width, int32 height);
+
+private:
+
+	FDisplayModeIndex();
+
+	void ConditionalBuild();
+	void Build(FScreenResolutionArray& resolutions, bool bEnumerated);
+
+	void StartEnumeration();
+	void FinishEnumeration(FScreenResolutionArray& resolutions, bool bEnumerated, int32 generation);
+
+	bool TryBindDisplayChanges(float deltaTime);
+	void OnDisplayMetricsChanged(const FDisplayMetrics& metrics);
+
+	FResolutionProvider Provider;
+	bool bBuilt;
+
+	//bumped by Invalidate, so an enumeration started before it is thrown away
+	int32 Generation;
+	bool bEnumerating;
+	TArray<TFunction<void()>> ReadyCallbacks;
+
+	FDelegateHandle DisplayMetricsHandle;
+	FDelegateHandle BindTickerHandle;
+
+	TArray<FDisplayMode> Modes;
+	//indices into Modes, ascending by width
+	TMap<int32, TArray<int32>> ModesByAspect;
+};
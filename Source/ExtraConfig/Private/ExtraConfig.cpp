@@ -1,18 +1,72 @@
 // Copyright 1998-2015 Epic Games, Inc. All Rights Reserved.
 
 #include "ExtraConfigPrivatePCH.h"
+#include "GraphicsConfig.h"
+#include "ConfigPersistence.h"
+#include "ConfigBackend.h"
+#include "ConfigNotifications.h"
+#include "ConfigSnapshot.h"
+#include "SettingsCache.h"
+#include "DisplayModeIndex.h"
+#include "AnalogConfigIndex.h"
 
 #define LOCTEXT_NAMESPACE "FExtraConfigModule"
 
+DEFINE_LOG_CATEGORY(LogExtraConfig);
+
+DEFINE_STAT(STAT_ExtraConfig_ConfigFlushes);
+DEFINE_STAT(STAT_ExtraConfig_FilesWritten);
+DEFINE_STAT(STAT_ExtraConfig_BytesWritten);
+DEFINE_STAT(STAT_ExtraConfig_KeyMapRebuilds);
+DEFINE_STAT(STAT_ExtraConfig_ResolutionApplies);
+
+//Runs once the engine is fully up, as applying settings may recreate render state
+static bool ApplyFirstLaunchPreset(float deltaTime)
+{
+	UGraphicsConfig::ApplyRecommendedPresetOnFirstLaunch();
+	return false;
+}
+
 void FExtraConfigModule::StartupModule()
 {
 	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
+	double start = FPlatformTime::Seconds();
+
+	FConfigPersistence::Startup();
+
+	//saved Input.ini files from older versions can hold several AxisConfig entries per key
+	FAnalogConfigIndex::CompactSettings(IConfigBackend::Get().GetInputSettings());
+
+	//a cache hit means the ini files are as the plugin last wrote them, so already migrated
+	bool bCacheHit = FSettingsCache::Load();
+
+	FConfigPersistence::EnableDeltaWrites(GInputIni, TEXT("Input"), !bCacheHit);
+	FConfigPersistence::EnableDeltaWrites(GEngineIni, TEXT("Engine"), !bCacheHit);
+	FConfigPersistence::EnableDeltaWrites(GGameIni, TEXT("Game"), !bCacheHit);
+	FConfigPersistence::EnableDeltaWrites(GGameUserSettingsIni, TEXT("GameUserSettings"), !bCacheHit);
+	FConfigSnapshot::PublishCurrent();
+	FDisplayModeIndex::Get().BindDisplayChanges();
+
+	//compare launches with and without ExtraConfigCache.bin to see what the cache saves
+	UE_LOG(LogExtraConfig, Log, TEXT("Startup took %.2f ms, settings cache %s"),
+		(FPlatformTime::Seconds() - start) * 1000.0, bCacheHit ? TEXT("hit") : TEXT("missed"));
+
+	//the editor and commandlets shouldn't change the player's settings
+	if (!GIsEditor && !IsRunningCommandlet())
+	{
+		FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateStatic(&ApplyFirstLaunchPreset));
+	}
 }
 
 void FExtraConfigModule::ShutdownModule()
 {
 	// This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
 	// we call this function before unloading the module.
+	UConfigNotifications::Shutdown();
+	FDisplayModeIndex::Get().UnbindDisplayChanges();
+	FConfigSnapshot::Shutdown();
+	FConfigPersistence::Shutdown();
+	FSettingsCache::Save();
 }
 
 #undef LOCTEXT_NAMESPACE
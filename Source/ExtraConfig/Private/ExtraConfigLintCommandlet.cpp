@@ -0,0 +1,340 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ExtraConfigPrivatePCH.h"
+#include "ExtraConfigLintCommandlet.h"
+#include "ConfigLint.h"
+#include "GraphicsSettingDescriptors.h"
+#include "Async/ParallelFor.h"
+
+struct FLintFileResult
+{
+	FConfigLintResult Lint;
+	int64 BytesBefore;
+	int64 BytesAfter;
+	bool bRewritten;
+	bool bFailed;
+
+	FLintFileResult() : BytesBefore(0), BytesAfter(0), bRewritten(false), bFailed(false) {}
+};
+
+UExtraConfigLintCommandlet::UExtraConfigLintCommandlet(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+//Runs on task graph workers, so only file I/O and FConfigLint
+static void LintFile(const FString& filename, bool bFix, FLintFileResult& outResult)
+{
+	FString text;
+	if (!FFileHelper::LoadFileToString(text, *filename))
+	{
+		outResult.bFailed = true;
+		return;
+	}
+
+	FString linted;
+	outResult.Lint = FConfigLint::Lint(text, linted);
+	outResult.BytesBefore = FTCHARToUTF8(*text).Length();
+	outResult.BytesAfter = FTCHARToUTF8(*linted).Length();
+
+	//files that are only reformatted stay as they are unless that makes them smaller
+	if (!bFix || (outResult.Lint.GetFixCount() == 0 && outResult.BytesAfter >= outResult.BytesBefore))
+	{
+		return;
+	}
+
+	FString tempFilename = filename + TEXT(".tmp");
+	if (!FFileHelper::SaveStringToFile(linted, *tempFilename) || !IFileManager::Get().Move(*filename, *tempFilename, true, true))
+	{
+		IFileManager::Get().Delete(*tempFilename);
+		outResult.bFailed = true;
+		return;
+	}
+
+	outResult.bRewritten = true;
+}
+
+// ----------------
+// Synthetic corpus
+// ----------------
+
+static const TCHAR* SyntheticKeys[] =
+{
+	TEXT("W"), TEXT("A"), TEXT("S"), TEXT("D"), TEXT("E"), TEXT("Q"), TEXT("R"), TEXT("F"), TEXT("SpaceBar"), TEXT("LeftShift"),
+	TEXT("LeftControl"), TEXT("Tab"), TEXT("One"), TEXT("Two"), TEXT("Three"), TEXT("Gamepad_FaceButton_Bottom"),
+	TEXT("Gamepad_FaceButton_Right"), TEXT("Gamepad_LeftShoulder"), TEXT("Gamepad_RightShoulder"), TEXT("LeftMouseButton"),
+};
+
+static const TCHAR* SyntheticAnalogKeys[] =
+{
+	TEXT("MouseX"), TEXT("MouseY"), TEXT("Gamepad_LeftX"), TEXT("Gamepad_LeftY"), TEXT("Gamepad_RightX"), TEXT("Gamepad_RightY"),
+};
+
+static const TCHAR* RandomKey(FRandomStream& random)
+{
+	return SyntheticKeys[random.RandHelper(ARRAY_COUNT(SyntheticKeys))];
+}
+
+static const TCHAR* RandomBool(FRandomStream& random, float chance)
+{
+	return random.FRand() < chance ? TEXT("True") : TEXT("False");
+}
+
+//A descriptor value, out of range or written twice now and then
+static void AddSyntheticCVars(FRandomStream& random, FString& text)
+{
+	for (const FGraphicsSettingDescriptor& desc : GraphicsSettingDescriptors)
+	{
+		int32 value = random.RandRange(desc.MinValue, desc.MaxValue);
+		if (random.FRand() < 0.1f)
+		{
+			value = desc.MaxValue + random.RandRange(1, 5);
+		}
+
+		text += FString::Printf(TEXT("%s=%d") LINE_TERMINATOR, desc.CVarName, value);
+
+		if (random.FRand() < 0.05f)
+		{
+			text += FString::Printf(TEXT("%s=%d") LINE_TERMINATOR, desc.CVarName, value);
+		}
+	}
+}
+
+static FString MakeSyntheticInput(FRandomStream& random)
+{
+	FString text = TEXT("[/Script/Engine.InputSettings]") LINE_TERMINATOR;
+	text += TEXT("bAltEnterTogglesFullscreen=True") LINE_TERMINATOR;
+
+	for (const TCHAR* analogKey : SyntheticAnalogKeys)
+	{
+		//rebinding screens that add instead of modify leave several entries per key behind
+		int32 copies = random.FRand() < 0.3f ? random.RandRange(2, 4) : 1;
+		for (int32 i = 0; i < copies; i++)
+		{
+			float deadZone = random.FRand() < 0.05f ? 1.f + random.FRand() : random.FRand() * 0.3f;
+			text += FString::Printf(TEXT("+AxisConfig=(AxisKeyName=\"%s\",AxisProperties=(DeadZone=%f,Sensitivity=%f,Exponent=%f,bInvert=%s))") LINE_TERMINATOR,
+				analogKey, deadZone, 0.05f + random.FRand(), 1.f + random.FRand(), RandomBool(random, 0.1f));
+		}
+	}
+
+	int32 actions = random.RandRange(10, 40);
+	for (int32 i = 0; i < actions; i++)
+	{
+		FString mapping = FString::Printf(TEXT("+ActionMappings=(ActionName=\"Action%02d\",Key=%s,bShift=%s,bCtrl=%s,bAlt=False,bCmd=False)") LINE_TERMINATOR,
+			i, random.FRand() < 0.03f ? TEXT("None") : RandomKey(random), RandomBool(random, 0.1f), RandomBool(random, 0.1f));
+
+		text += mapping;
+		if (random.FRand() < 0.2f)
+		{
+			text += mapping;
+		}
+	}
+
+	int32 axes = random.RandRange(4, 12);
+	for (int32 i = 0; i < axes; i++)
+	{
+		FString mapping = FString::Printf(TEXT("+AxisMappings=(AxisName=\"Axis%02d\",Key=%s,Scale=%f)") LINE_TERMINATOR,
+			i / 2, RandomKey(random), (i % 2) ? -1.f : 1.f);
+
+		text += mapping;
+		if (random.FRand() < 0.2f)
+		{
+			text += mapping;
+		}
+	}
+
+	return text;
+}
+
+static FString MakeSyntheticEngine(FRandomStream& random)
+{
+	FString text = TEXT("[Core.System]") LINE_TERMINATOR;
+	text += TEXT("Paths=../../../Engine/Content") LINE_TERMINATOR;
+	text += TEXT("Paths=%GAMEDIR%Content") LINE_TERMINATOR;
+	text += LINE_TERMINATOR TEXT("[ConsoleVariables]") LINE_TERMINATOR;
+
+	AddSyntheticCVars(random, text);
+
+	return text;
+}
+
+static FString MakeSyntheticGameUserSettings(FRandomStream& random)
+{
+	FString text = TEXT("[ScalabilityGroups]") LINE_TERMINATOR;
+	text += FString::Printf(TEXT("sg.ResolutionQuality=%d") LINE_TERMINATOR, random.RandRange(50, 100));
+
+	AddSyntheticCVars(random, text);
+
+	text += LINE_TERMINATOR TEXT("[/Script/Engine.GameUserSettings]") LINE_TERMINATOR;
+	text += FString::Printf(TEXT("bUseVSync=%s") LINE_TERMINATOR, RandomBool(random, 0.5f));
+	text += TEXT("ResolutionSizeX=1920") LINE_TERMINATOR TEXT("ResolutionSizeY=1080") LINE_TERMINATOR;
+	text += FString::Printf(TEXT("FullscreenMode=%d") LINE_TERMINATOR, random.RandRange(0, 2));
+
+	//older plugin versions appended a second section instead of updating the first
+	if (random.FRand() < 0.1f)
+	{
+		text += LINE_TERMINATOR TEXT("[ScalabilityGroups]") LINE_TERMINATOR;
+		text += FString::Printf(TEXT("sg.ShadowQuality=%d") LINE_TERMINATOR, random.RandRange(0, 3));
+	}
+
+	text += LINE_TERMINATOR TEXT("[ExtraConfig.Display]") LINE_TERMINATOR;
+	text += FString::Printf(TEXT("RefreshRate=%d") LINE_TERMINATOR, random.FRand() < 0.5f ? 60 : 144);
+
+	return text;
+}
+
+//One user directory per three files, each with an Input, Engine and GameUserSettings ini
+static void GenerateCorpus(const FString& dir, int32 count, bool bSingleThread)
+{
+	double start = FPlatformTime::Seconds();
+	FThreadSafeCounter failed;
+
+	ParallelFor(count, [&dir, &failed](int32 i)
+	{
+		//seeded by index, so a corpus of the same size is the same on every run
+		FRandomStream random(i);
+
+		FString userDir = dir / FString::Printf(TEXT("User%06d"), i / 3);
+		FString filename;
+		FString text;
+
+		switch (i % 3)
+		{
+		case 0:
+			filename = userDir / TEXT("Input.ini");
+			text = MakeSyntheticInput(random);
+			break;
+		case 1:
+			filename = userDir / TEXT("Engine.ini");
+			text = MakeSyntheticEngine(random);
+			break;
+		default:
+			filename = userDir / TEXT("GameUserSettings.ini");
+			text = MakeSyntheticGameUserSettings(random);
+			break;
+		}
+
+		if (!FFileHelper::SaveStringToFile(text, *filename))
+		{
+			failed.Increment();
+		}
+	}, bSingleThread);
+
+	UE_LOG(LogExtraConfig, Display, TEXT("Generated %d synthetic configs in %s in %.2f s, %d failed"),
+		count, *dir, FPlatformTime::Seconds() - start, failed.GetValue());
+}
+
+// ------
+// Report
+// ------
+
+static bool WriteReport(const FString& reportFilename, const TArray<FString>& files, const TArray<FLintFileResult>& results, const FString& summary)
+{
+	FString report = summary + LINE_TERMINATOR;
+	report += TEXT("File,DuplicateMappings,DuplicateAxisConfigs,DuplicateKeys,InvalidMappings,ClampedValues,MergedSections,ConflictingKeys,UnparsedEntries,BytesBefore,BytesAfter,Rewritten,Failed") LINE_TERMINATOR;
+
+	for (int32 i = 0; i < files.Num(); i++)
+	{
+		const FLintFileResult& result = results[i];
+		if (result.Lint.GetProblemCount() == 0 && !result.bFailed)
+		{
+			continue;
+		}
+
+		const FConfigLintResult& lint = result.Lint;
+		report += FString::Printf(TEXT("\"%s\",%d,%d,%d,%d,%d,%d,%d,%d,%lld,%lld,%d,%d") LINE_TERMINATOR,
+			*files[i], lint.DuplicateMappings, lint.DuplicateAxisConfigs, lint.DuplicateKeys, lint.InvalidMappings, lint.ClampedValues,
+			lint.MergedSections, lint.ConflictingKeys, lint.UnparsedEntries, result.BytesBefore, result.BytesAfter, result.bRewritten, result.bFailed);
+	}
+
+	return FFileHelper::SaveStringToFile(report, *reportFilename);
+}
+
+int32 UExtraConfigLintCommandlet::Main(const FString& params)
+{
+	FString dir;
+	if (!FParse::Value(*params, TEXT("dir="), dir))
+	{
+		UE_LOG(LogExtraConfig, Error, TEXT("Usage: -run=ExtraConfigLint -dir=<path> [-fix] [-report=<file>] [-generate=<count>] [-singlethread]"));
+		return 1;
+	}
+
+	dir = FPaths::ConvertRelativePathToFull(dir);
+
+	bool bFix = FParse::Param(*params, TEXT("fix"));
+	bool bSingleThread = FParse::Param(*params, TEXT("singlethread"));
+
+	int32 generate = 0;
+	FParse::Value(*params, TEXT("generate="), generate);
+
+	FString reportFilename;
+	FParse::Value(*params, TEXT("report="), reportFilename);
+
+	if (generate > 0)
+	{
+		GenerateCorpus(dir, generate, bSingleThread);
+	}
+
+	TArray<FString> files;
+	IFileManager::Get().FindFilesRecursive(files, *dir, TEXT("*.ini"), true, false);
+	//the report lists files in the same order on every run
+	files.Sort();
+
+	TArray<FLintFileResult> results;
+	results.SetNum(files.Num());
+
+	double start = FPlatformTime::Seconds();
+
+	ParallelFor(files.Num(), [&files, &results, bFix](int32 i)
+	{
+		LintFile(files[i], bFix, results[i]);
+	}, bSingleThread);
+
+	double seconds = FPlatformTime::Seconds() - start;
+
+	FConfigLintResult total;
+	int32 withProblems = 0;
+	int32 rewritten = 0;
+	int32 failed = 0;
+	int64 bytesBefore = 0;
+	int64 bytesAfter = 0;
+
+	for (const FLintFileResult& result : results)
+	{
+		total.Accumulate(result.Lint);
+		withProblems += result.Lint.GetProblemCount() > 0 ? 1 : 0;
+		rewritten += result.bRewritten ? 1 : 0;
+		failed += result.bFailed ? 1 : 0;
+		bytesBefore += result.BytesBefore;
+		bytesAfter += result.BytesAfter;
+	}
+
+	int32 threads = bSingleThread ? 1 : FTaskGraphInterface::Get().GetNumWorkerThreads() + 1;
+
+	FString summary = FString::Printf(TEXT("Linted %d files in %.2f s (%.0f files/s, %d threads): %d with problems, %d rewritten, %d failed"),
+		files.Num(), seconds, seconds > 0.0 ? files.Num() / seconds : 0.0, threads, withProblems, rewritten, failed);
+
+	UE_LOG(LogExtraConfig, Display, TEXT("%s"), *summary);
+	UE_LOG(LogExtraConfig, Display, TEXT("  Removed: %d duplicate mappings, %d duplicate axis configs, %d duplicate keys, %d invalid mappings"),
+		total.DuplicateMappings, total.DuplicateAxisConfigs, total.DuplicateKeys, total.InvalidMappings);
+	UE_LOG(LogExtraConfig, Display, TEXT("  Fixed: %d values clamped, %d sections merged"), total.ClampedValues, total.MergedSections);
+	UE_LOG(LogExtraConfig, Display, TEXT("  Left for review: %d conflicting keys, %d unparsed entries"), total.ConflictingKeys, total.UnparsedEntries);
+	UE_LOG(LogExtraConfig, Display, TEXT("  Size%s: %lld -> %lld bytes"), bFix ? TEXT("") : TEXT(" if fixed"), bytesBefore, bytesAfter);
+
+	if (!reportFilename.IsEmpty())
+	{
+		if (WriteReport(reportFilename, files, results, summary))
+		{
+			UE_LOG(LogExtraConfig, Display, TEXT("Wrote report to %s"), *reportFilename);
+		}
+		else
+		{
+			UE_LOG(LogExtraConfig, Error, TEXT("Failed to write report to %s"), *reportFilename);
+		}
+	}
+
+	return failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,12 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+DECLARE_STATS_GROUP(TEXT("ExtraConfig"), STATGROUP_ExtraConfig, STATCAT_Advanced);
+
+//Events counted across the module, to tie hitches to config work
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Config Flushes"), STAT_ExtraConfig_ConfigFlushes, STATGROUP_ExtraConfig, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Config Files Written"), STAT_ExtraConfig_FilesWritten, STATGROUP_ExtraConfig, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Config Bytes Written"), STAT_ExtraConfig_BytesWritten, STATGROUP_ExtraConfig, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("ForceRebuildingKeyMaps Calls"), STAT_ExtraConfig_KeyMapRebuilds, STATGROUP_ExtraConfig, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Resolution Applies"), STAT_ExtraConfig_ResolutionApplies, STATGROUP_ExtraConfig, );
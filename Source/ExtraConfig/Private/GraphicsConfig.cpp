@@ -2,30 +2,377 @@
 
 #include "ExtraConfigPrivatePCH.h"
 #include "GraphicsConfig.h"
+#include "ConfigPersistence.h"
+#include "ConfigBackend.h"
+#include "ConfigNotifications.h"
+#include "ConfigSnapshot.h"
+#include "GraphicsSettingDescriptors.h"
+#include "HardwareDetection.h"
+#include "DisplayModeIndex.h"
+#include "ConfigLatentAction.h"
 #include "GameFramework/GameUserSettings.h"
 #include "Runtime/Core/Public/Misc/ConfigCacheIni.h"
 #include "Engine.h"
 #include "RHI.h"
 
+DECLARE_CYCLE_STAT(TEXT("UGraphicsConfig::SetResolution"), STAT_ExtraConfig_SetResolution, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UGraphicsConfig::ApplyDisplayMode"), STAT_ExtraConfig_ApplyDisplayMode, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UGraphicsConfig::GetRefreshRate"), STAT_ExtraConfig_GetRefreshRate, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UGraphicsConfig::GetCurrentResolution"), STAT_ExtraConfig_GetCurrentResolution, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UGraphicsConfig::GetDefaultResolution"), STAT_ExtraConfig_GetDefaultResolution, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UGraphicsConfig::GetValidResolutions"), STAT_ExtraConfig_GetValidResolutions, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UGraphicsConfig::GetRefreshRates"), STAT_ExtraConfig_GetRefreshRates, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UGraphicsConfig::GetLargestResolution"), STAT_ExtraConfig_GetLargestResolution, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UGraphicsConfig::RefreshDisplayModes"), STAT_ExtraConfig_RefreshDisplayModes, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UGraphicsConfig::GetScreenMode"), STAT_ExtraConfig_GetScreenMode, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UGraphicsConfig::SetScreenMode"), STAT_ExtraConfig_SetScreenMode, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UGraphicsConfig::GetGraphicsPreset"), STAT_ExtraConfig_GetGraphicsPreset, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UGraphicsConfig::SetGraphicsPreset"), STAT_ExtraConfig_SetGraphicsPreset, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UGraphicsConfig::RequestValidResolutions"), STAT_ExtraConfig_RequestValidResolutions, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UGraphicsConfig::RequestResolution"), STAT_ExtraConfig_RequestResolution, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UGraphicsConfig::RequestScreenMode"), STAT_ExtraConfig_RequestScreenMode, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UGraphicsConfig::BeginGraphicsChanges"), STAT_ExtraConfig_BeginGraphicsChanges, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UGraphicsConfig::CommitGraphicsChanges"), STAT_ExtraConfig_CommitGraphicsChanges, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UGraphicsConfig::GetPendingGraphicsApply"), STAT_ExtraConfig_GetPendingGraphicsApply, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UGraphicsConfig::ApplyGraphicsSettings"), STAT_ExtraConfig_ApplyGraphicsSettings, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UGraphicsConfig::DetectRecommendedPreset"), STAT_ExtraConfig_DetectRecommendedPreset, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UGraphicsConfig::ApplyRecommendedPresetOnFirstLaunch"), STAT_ExtraConfig_ApplyRecommendedPresetOnFirstLaunch, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UGraphicsConfig::GetGraphicsSettings"), STAT_ExtraConfig_GetGraphicsSettings, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UGraphicsConfig::GetGraphicsSettingsGeneration"), STAT_ExtraConfig_GetGraphicsSettingsGeneration, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UGraphicsConfig::InvalidateGraphicsSettings"), STAT_ExtraConfig_InvalidateGraphicsSettings, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UGraphicsConfig::PrimeGraphicsSettings"), STAT_ExtraConfig_PrimeGraphicsSettings, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UGraphicsConfig::ReadGraphicsSettingsFromConfig"), STAT_ExtraConfig_ReadGraphicsSettingsFromConfig, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UGraphicsConfig::GetGraphicsSetting"), STAT_ExtraConfig_GetGraphicsSetting, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UGraphicsConfig::SetGraphicsSetting"), STAT_ExtraConfig_SetGraphicsSetting, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UGraphicsConfig::GetGraphicsSettingApply"), STAT_ExtraConfig_GetGraphicsSettingApply, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UGraphicsConfig::DiffGraphicsSettings"), STAT_ExtraConfig_DiffGraphicsSettings, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UGraphicsConfig::ToggleVSync"), STAT_ExtraConfig_ToggleVSync, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UGraphicsConfig::SetAnisotropic"), STAT_ExtraConfig_SetAnisotropic, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UGraphicsConfig::SetAntialiasing"), STAT_ExtraConfig_SetAntialiasing, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UGraphicsConfig::SetShadowQuality"), STAT_ExtraConfig_SetShadowQuality, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UGraphicsConfig::SetAmbientOcclusion"), STAT_ExtraConfig_SetAmbientOcclusion, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UGraphicsConfig::SetReflections"), STAT_ExtraConfig_SetReflections, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UGraphicsConfig::SetMotionBlur"), STAT_ExtraConfig_SetMotionBlur, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UGraphicsConfig::SetLensFlare"), STAT_ExtraConfig_SetLensFlare, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UGraphicsConfig::SetBloom"), STAT_ExtraConfig_SetBloom, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UGraphicsConfig::ToggleSimpleLighting"), STAT_ExtraConfig_ToggleSimpleLighting, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UGraphicsConfig::SetViewDistanceQuality"), STAT_ExtraConfig_SetViewDistanceQuality, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UGraphicsConfig::SetTextureQuality"), STAT_ExtraConfig_SetTextureQuality, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UGraphicsConfig::SetEffectsQuality"), STAT_ExtraConfig_SetEffectsQuality, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UGraphicsConfig::SetPostProcessQuality"), STAT_ExtraConfig_SetPostProcessQuality, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UGraphicsConfig::SetFoliageQuality"), STAT_ExtraConfig_SetFoliageQuality, STATGROUP_ExtraConfig);
+
+//Depth of nested BeginGraphicsChanges calls, and the ini files waiting on the outermost commit
+static int32 GraphicsBatchDepth = 0;
+static TArray<FString> PendingFlushes;
+
+//Console variable writes waiting to be applied to the running engine
+struct FPendingCVar
+{
+	const TCHAR* Name;
+	int32 Value;
+	EGraphicsApply Apply;
+	bool bRecreateRenderState;
+};
+
+static TArray<FPendingCVar> PendingCVars;
+
+//Values held back until the next map load, or until the game restarts
+static TMap<FString, int32> NextLevelCVars;
+static TMap<FString, int32> RestartCVars;
+
+static void SetLiveCVar(const TCHAR* name, int32 value)
+{
+	IConfigBackend& backend = IConfigBackend::Get();
+
+	int32 current = 0;
+	if (backend.GetCVar(name, current) && current != value)
+	{
+		backend.SetCVar(name, value);
+	}
+}
+
+static void ApplyNextLevelCVars()
+{
+	for (auto& entry : NextLevelCVars)
+	{
+		SetLiveCVar(*entry.Key, entry.Value);
+	}
+
+	NextLevelCVars.Empty();
+}
+
+static void ApplyPendingCVars()
+{
+	static bool bBoundPostLoadMap = false;
+	bool bRecreateRenderState = false;
+
+	for (const FPendingCVar& pending : PendingCVars)
+	{
+		switch (pending.Apply)
+		{
+		case EGraphicsApply::Instant:
+			SetLiveCVar(pending.Name, pending.Value);
+			bRecreateRenderState |= pending.bRecreateRenderState;
+			break;
+		case EGraphicsApply::NextLevel:
+		{
+			int32 live = 0;
+			if (IConfigBackend::Get().GetCVar(pending.Name, live) && live == pending.Value)
+			{
+				NextLevelCVars.Remove(pending.Name);
+				break;
+			}
+
+			NextLevelCVars.Add(pending.Name, pending.Value);
+			if (!bBoundPostLoadMap)
+			{
+				FCoreUObjectDelegates::PostLoadMap.AddStatic(&ApplyNextLevelCVars);
+				bBoundPostLoadMap = true;
+			}
+			break;
+		}
+		case EGraphicsApply::Restart:
+		{
+			//the live cvar still holds the value the game started with
+			int32 live = 0;
+			if (IConfigBackend::Get().GetCVar(pending.Name, live) && live == pending.Value)
+			{
+				RestartCVars.Remove(pending.Name);
+			}
+			else
+			{
+				RestartCVars.Add(pending.Name, pending.Value);
+			}
+			break;
+		}
+		}
+	}
+
+	PendingCVars.Empty();
+
+	//one recreation covers every instant change in the commit
+	if (bRecreateRenderState)
+	{
+		IConfigBackend::Get().RecreateRenderState();
+	}
+}
+
+static void SetConsoleVariable(const TCHAR* name, int32 value, EGraphicsApply apply, bool bRecreateRenderState = false)
+{
+	IConfigBackend::Get().SetString(TEXT("ConsoleVariables"), name, FString::FromInt(value), GEngineIni);
+
+	for (FPendingCVar& pending : PendingCVars)
+	{
+		if (FCString::Strcmp(pending.Name, name) == 0)
+		{
+			pending.Value = value;
+			return;
+		}
+	}
+
+	FPendingCVar pending = { name, value, apply, bRecreateRenderState };
+	PendingCVars.Add(pending);
+}
+
+static void FlushConfig(const FString& filename)
+{
+	if (GraphicsBatchDepth > 0)
+	{
+		PendingFlushes.AddUnique(filename);
+		return;
+	}
+
+	IConfigBackend::Get().QueueWrite(filename);
+	ApplyPendingCVars();
+
+	FConfigSnapshot::PublishCurrent();
+}
+
+const FGraphicsSettingDescriptor GraphicsSettingDescriptors[(int32)EGraphicsSetting::MAX] =
+{
+	{ EGraphicsSetting::VSync,			TEXT("r.VSync"),					0, 1,	0,	EGraphicsApply::Instant,	false,	GRAPHICS_SETTING_FIELD(VSync) },
+	{ EGraphicsSetting::Anisotropic,	TEXT("r.MaxAnisotropy"),			0, 16,	4,	EGraphicsApply::NextLevel,	false,	GRAPHICS_SETTING_FIELD(Anisotropic) },
+	{ EGraphicsSetting::Antialiasing,	TEXT("r.PostProcessAAQuality"),		0, 4,	3,	EGraphicsApply::Instant,	false,	GRAPHICS_SETTING_FIELD(Antialiasing) },
+	{ EGraphicsSetting::Shadows,		TEXT("sg.ShadowQuality"),			0, 3,	2,	EGraphicsApply::Instant,	true,	GRAPHICS_SETTING_FIELD(Shadows) },
+	{ EGraphicsSetting::SSAO,			TEXT("r.AmbientOcclusionLevels"),	0, 3,	2,	EGraphicsApply::Instant,	false,	GRAPHICS_SETTING_FIELD(SSAO) },
+	{ EGraphicsSetting::Reflections,	TEXT("r.SSR.Quality"),				0, 3,	2,	EGraphicsApply::Instant,	false,	GRAPHICS_SETTING_FIELD(Reflections) },
+	{ EGraphicsSetting::MotionBlur,		TEXT("r.MotionBlurQuality"),		0, 3,	0,	EGraphicsApply::Instant,	false,	GRAPHICS_SETTING_FIELD(MotionBlur) },
+	{ EGraphicsSetting::LensFlare,		TEXT("r.LensFlareQuality"),			0, 3,	0,	EGraphicsApply::Instant,	false,	GRAPHICS_SETTING_FIELD(LensFlare) },
+	{ EGraphicsSetting::Bloom,			TEXT("r.BloomQuality"),				0, 4,	0,	EGraphicsApply::Instant,	false,	GRAPHICS_SETTING_FIELD(Bloom) },
+	{ EGraphicsSetting::SimpleLighting,	TEXT("r.SimpleDynamicLighting"),	0, 1,	0,	EGraphicsApply::Restart,	false,	GRAPHICS_SETTING_FIELD(SimpleLighting) },
+	{ EGraphicsSetting::ViewDistance,	TEXT("sg.ViewDistanceQuality"),		0, 3,	3,	EGraphicsApply::Instant,	false,	GRAPHICS_SETTING_FIELD(ViewDistance) },
+	{ EGraphicsSetting::Textures,		TEXT("sg.TextureQuality"),			0, 3,	3,	EGraphicsApply::Instant,	false,	GRAPHICS_SETTING_FIELD(Textures) },
+	{ EGraphicsSetting::Effects,		TEXT("sg.EffectsQuality"),			0, 3,	3,	EGraphicsApply::Instant,	false,	GRAPHICS_SETTING_FIELD(Effects) },
+	{ EGraphicsSetting::PostProcess,	TEXT("sg.PostProcessQuality"),		0, 3,	3,	EGraphicsApply::Instant,	false,	GRAPHICS_SETTING_FIELD(PostProcess) },
+	{ EGraphicsSetting::Foliage,		TEXT("sg.FoliageQuality"),			0, 3,	3,	EGraphicsApply::Instant,	false,	GRAPHICS_SETTING_FIELD(Foliage) },
+};
+
+//In-memory copy of the [ConsoleVariables] values, kept current by the setters
+static FGraphicsSettings CachedSettings;
+static bool bCachedSettingsValid = false;
+static int32 SettingsGeneration = 1;
+
 UGraphicsConfig::UGraphicsConfig(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
 {
 }
 
+static EWindowMode::Type ToWindowMode(EScreenMode mode)
+{
+	switch (mode)
+	{
+	default:
+	case EScreenMode::Exclusive:
+		return EWindowMode::Fullscreen;
+	case EScreenMode::Borderless:
+		return EWindowMode::WindowedFullscreen;
+	case EScreenMode::Window:
+		return EWindowMode::Windowed;
+	}
+}
+
+//Typed reads and writes of the plugin's own ini keys, through the backend like everything else
+static bool GetConfigInt(const TCHAR* section, const TCHAR* key, int32& outValue, const FString& filename)
+{
+	FString text;
+	if (!IConfigBackend::Get().GetString(section, key, text, filename))
+	{
+		return false;
+	}
+
+	outValue = FCString::Atoi(*text);
+	return true;
+}
+
+static bool GetConfigFloat(const TCHAR* section, const TCHAR* key, float& outValue, const FString& filename)
+{
+	FString text;
+	if (!IConfigBackend::Get().GetString(section, key, text, filename))
+	{
+		return false;
+	}
+
+	outValue = FCString::Atof(*text);
+	return true;
+}
+
+static void SetConfigInt(const TCHAR* section, const TCHAR* key, int32 value, const FString& filename)
+{
+	IConfigBackend::Get().SetString(section, key, FString::FromInt(value), filename);
+}
+
+static void SetConfigFloat(const TCHAR* section, const TCHAR* key, float value, const FString& filename)
+{
+	IConfigBackend::Get().SetString(section, key, FString::SanitizeFloat(value), filename);
+}
+
+static const TCHAR* DisplaySection = TEXT("ExtraConfig.Display");
+
+//the stored refresh rate, kept unless exclusive fullscreen at this resolution doesn't offer it
+static int32 GetRefreshRateFor(int32 width, int32 height, EScreenMode mode)
+{
+	int32 refreshRate = UGraphicsConfig::GetRefreshRate();
+
+	if (refreshRate > 0 && ToWindowMode(mode) == EWindowMode::Fullscreen && FDisplayModeIndex::Get().GetModes().Num() > 0)
+	{
+		const FDisplayMode* displayMode = FDisplayModeIndex::Get().Find(width, height);
+		if (!displayMode || !displayMode->RefreshRates.Contains(refreshRate))
+		{
+			return 0;
+		}
+	}
+
+	return refreshRate;
+}
+
 void UGraphicsConfig::SetResolution(int32 width, int32 height)
 {
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_SetResolution);
+
+	EScreenMode mode = GetScreenMode();
+
+	ApplyDisplayMode(width, height, mode, GetRefreshRateFor(width, height, mode));
+}
+
+bool UGraphicsConfig::ApplyDisplayMode(int32 width, int32 height, EScreenMode mode, int32 refreshRate)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_ApplyDisplayMode);
+
 	UGameUserSettings* settings = GEngine->GameUserSettings;
 
+	if (width <= 0 || height <= 0)
+	{
+		return false;
+	}
+
+	EWindowMode::Type windowMode = ToWindowMode(mode);
+
+	//exclusive fullscreen has to match a mode the display supports; an empty list means the RHI couldn't tell us
+	if (windowMode == EWindowMode::Fullscreen && FDisplayModeIndex::Get().GetModes().Num() > 0)
+	{
+		const FDisplayMode* displayMode = FDisplayModeIndex::Get().Find(width, height);
+		if (!displayMode || (refreshRate > 0 && !displayMode->RefreshRates.Contains(refreshRate)))
+		{
+			return false;
+		}
+	}
+
 	FIntPoint res(width, height);
 
+	int32 changed = 0;
+	if (settings->GetScreenResolution() != res)
+	{
+		changed |= 1 << (int32)EConfigChange::Resolution;
+	}
+	if (settings->GetFullscreenMode() != windowMode)
+	{
+		changed |= 1 << (int32)EConfigChange::ScreenMode;
+	}
+	//no RefreshRate bit: the rate is only stored for the RHI to pick from, nothing on screen changes
+
+	bool bSettingsMatch = settings->GetScreenResolution() == res && settings->GetFullscreenMode() == windowMode && GetRefreshRate() == refreshRate;
+	bool bAppliedMatch = GSystemResolution.ResX == (uint32)width && GSystemResolution.ResY == (uint32)height && GSystemResolution.WindowMode == windowMode;
+
+	if (bSettingsMatch && bAppliedMatch)
+	{
+		return true;
+	}
+
 	settings->SetScreenResolution(res);
+	settings->SetFullscreenMode(windowMode);
+
+	//one mode switch for resolution and window mode together
+	if (!bAppliedMatch)
+	{
+		INC_DWORD_STAT(STAT_ExtraConfig_ResolutionApplies);
+		UE_LOG(LogExtraConfig, Verbose, TEXT("Applying display mode %dx%d, window mode %d"), width, height, (int32)windowMode);
 
-	settings->ApplyResolutionSettings(false);
+		settings->ApplyResolutionSettings(false);
+	}
 
+	FScopedDeferredConfigWrite deferWrite(GGameUserSettingsIni);
+	SetConfigInt(DisplaySection, TEXT("RefreshRate"), refreshRate, GGameUserSettingsIni);
 	settings->SaveSettings();
+
+	FConfigSnapshot::PublishCurrent();
+	UConfigNotifications::MarkChanged(changed, 0);
+
+	return true;
+}
+
+int32 UGraphicsConfig::GetRefreshRate()
+{
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_GetRefreshRate);
+
+	int32 refreshRate = 0;
+	GetConfigInt(DisplaySection, TEXT("RefreshRate"), refreshRate, GGameUserSettingsIni);
+	return refreshRate;
 }
 
 FInt2D UGraphicsConfig::GetCurrentResolution()
 {
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_GetCurrentResolution);
+
 	UGameUserSettings* settings = GEngine->GameUserSettings;
 
 	FIntPoint res = settings->GetScreenResolution();
@@ -35,6 +382,8 @@ FInt2D UGraphicsConfig::GetCurrentResolution()
 
 FInt2D UGraphicsConfig::GetDefaultResolution()
 {
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_GetDefaultResolution);
+
 	FIntPoint res = UGameUserSettings::GetDefaultResolution();
 
 	return FInt2D(res.X, res.Y);
@@ -42,24 +391,50 @@ FInt2D UGraphicsConfig::GetDefaultResolution()
 
 TArray<FInt2D> UGraphicsConfig::GetValidResolutions()
 {
-	FScreenResolutionArray resolutions;
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_GetValidResolutions);
+
+	const TArray<FDisplayMode>& modes = FDisplayModeIndex::Get().GetModes();
 	TArray<FInt2D> outResolutions;
 
-	RHIGetAvailableResolutions(resolutions, true);
+	outResolutions.Reserve(modes.Num());
 
-	for (const FScreenResolutionRHI& res : resolutions)
+	for (const FDisplayMode& mode : modes)
 	{
-		FInt2D outRes;
-		outRes.X = res.Width;
-		outRes.Y = res.Height;
-		outResolutions.Add(outRes);
+		outResolutions.Add(FInt2D(mode.Width, mode.Height));
 	}
 
 	return outResolutions;
 }
 
+TArray<int32> UGraphicsConfig::GetRefreshRates(int32 width, int32 height)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_GetRefreshRates);
+
+	const FDisplayMode* mode = FDisplayModeIndex::Get().Find(width, height);
+
+	return mode ? mode->RefreshRates : TArray<int32>();
+}
+
+FInt2D UGraphicsConfig::GetLargestResolution(int32 maxWidth, int32 maxHeight, int32 aspectX, int32 aspectY)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_GetLargestResolution);
+
+	const FDisplayMode* mode = FDisplayModeIndex::Get().FindLargestAtMost(maxWidth, maxHeight, aspectX, aspectY);
+
+	return mode ? FInt2D(mode->Width, mode->Height) : FInt2D(0, 0);
+}
+
+void UGraphicsConfig::RefreshDisplayModes()
+{
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_RefreshDisplayModes);
+
+	FDisplayModeIndex::Get().Invalidate();
+}
+
 EScreenMode UGraphicsConfig::GetScreenMode()
 {
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_GetScreenMode);
+
 	UGameUserSettings* settings = GEngine->GameUserSettings;
 
 	EWindowMode::Type inMode = settings->GetFullscreenMode();
@@ -82,35 +457,86 @@ EScreenMode UGraphicsConfig::GetScreenMode()
 
 void UGraphicsConfig::SetScreenMode(EScreenMode mode)
 {
-	UGameUserSettings* settings = GEngine->GameUserSettings;
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_SetScreenMode);
 
-	EWindowMode::Type outMode;
+	FInt2D res = GetCurrentResolution();
 
-	switch (mode)
+	ApplyDisplayMode(res.X, res.Y, mode, GetRefreshRateFor(res.X, res.Y, mode));
+}
+
+void UGraphicsConfig::GetValidResolutionsAsync(UObject* worldContextObject, FLatentActionInfo latentInfo, TArray<FInt2D>& resolutions)
+{
+	TConfigLatentAction<TArray<FInt2D>>::Start(worldContextObject, latentInfo, &resolutions, [](TFunction<void(const TArray<FInt2D>&)> onComplete)
 	{
-	default:
-	case EScreenMode::Exclusive:
-		outMode = EWindowMode::Fullscreen;
-		break;
-	case EScreenMode::Borderless:
-		outMode = EWindowMode::WindowedFullscreen;
-		break;
-	case EScreenMode::Window:
-		outMode = EWindowMode::Windowed;
-		break;
-	}
+		RequestValidResolutions(onComplete);
+	});
+}
 
-	settings->SetFullscreenMode(outMode);
+void UGraphicsConfig::SetResolutionAsync(UObject* worldContextObject, FLatentActionInfo latentInfo, int32 width, int32 height, bool& success)
+{
+	TConfigLatentAction<bool>::Start(worldContextObject, latentInfo, &success, [width, height](TFunction<void(const bool&)> onComplete)
+	{
+		RequestResolution(width, height, [onComplete](bool bApplied) { onComplete(bApplied); });
+	});
+}
+
+void UGraphicsConfig::SetScreenModeAsync(UObject* worldContextObject, FLatentActionInfo latentInfo, EScreenMode mode, bool& success)
+{
+	TConfigLatentAction<bool>::Start(worldContextObject, latentInfo, &success, [mode](TFunction<void(const bool&)> onComplete)
+	{
+		RequestScreenMode(mode, [onComplete](bool bApplied) { onComplete(bApplied); });
+	});
+}
 
-	settings->ApplyResolutionSettings(false);
+void UGraphicsConfig::RequestValidResolutions(TFunction<void(const TArray<FInt2D>&)> onComplete)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_RequestValidResolutions);
 
-	settings->SaveSettings();
+	FDisplayModeIndex::Get().BuildAsync([onComplete]()
+	{
+		onComplete(GetValidResolutions());
+	});
+}
+
+void UGraphicsConfig::RequestResolution(int32 width, int32 height, TFunction<void(bool)> onComplete)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_RequestResolution);
+
+	//validation needs the mode list; the switch itself has to happen on the game thread
+	FDisplayModeIndex::Get().BuildAsync([width, height, onComplete]()
+	{
+		EScreenMode mode = GetScreenMode();
+		bool bApplied = ApplyDisplayMode(width, height, mode, GetRefreshRateFor(width, height, mode));
+
+		IConfigBackend::Get().WhenWritten([bApplied, onComplete]()
+		{
+			onComplete(bApplied);
+		});
+	});
+}
+
+void UGraphicsConfig::RequestScreenMode(EScreenMode mode, TFunction<void(bool)> onComplete)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_RequestScreenMode);
+
+	FDisplayModeIndex::Get().BuildAsync([mode, onComplete]()
+	{
+		FInt2D res = GetCurrentResolution();
+		bool bApplied = ApplyDisplayMode(res.X, res.Y, mode, GetRefreshRateFor(res.X, res.Y, mode));
+
+		IConfigBackend::Get().WhenWritten([bApplied, onComplete]()
+		{
+			onComplete(bApplied);
+		});
+	});
 }
 
 EQuality UGraphicsConfig::GetGraphicsPreset()
 {
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_GetGraphicsPreset);
+
 	FString value;
-	GConfig->GetString(TEXT("Graphics"), TEXT("QualityPreset"), value, GGameIni);
+	IConfigBackend::Get().GetString(TEXT("Graphics"), TEXT("QualityPreset"), value, GGameIni);
 
 	if (value == "Low")
 	{
@@ -136,6 +562,8 @@ EQuality UGraphicsConfig::GetGraphicsPreset()
 
 void UGraphicsConfig::SetGraphicsPreset(EQuality level)
 {
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_SetGraphicsPreset);
+
 	FString value;
 
 	switch (level)
@@ -157,389 +585,462 @@ void UGraphicsConfig::SetGraphicsPreset(EQuality level)
 		value = "Custom";
 	}
 
-	GConfig->SetString(TEXT("Graphics"), TEXT("QualityPreset"), *value, GGameIni);
+	if (GetGraphicsPreset() != level)
+	{
+		UConfigNotifications::MarkChanged(EConfigChange::GraphicsPreset);
+	}
+
+	IConfigBackend::Get().SetString(TEXT("Graphics"), TEXT("QualityPreset"), value, GGameIni);
 
-	GConfig->Flush(false, GGameIni);
+	FlushConfig(GGameIni);
 }
 
-FGraphicsSettings UGraphicsConfig::GetGraphicsSettings()
+void UGraphicsConfig::BeginGraphicsChanges()
 {
-	FGraphicsSettings output;
-	int value;
-	bool bVal;
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_BeginGraphicsChanges);
 
-	//Get VSync toggle
-	GConfig->GetBool(TEXT("ConsoleVariables"), TEXT("r.VSync"), bVal, GEngineIni);
-	if (bVal)
-	{
-		output.VSync = 1;
-	}
-	else
-	{
-		output.VSync = 0;
-	}
+	GraphicsBatchDepth++;
+}
 
-	GConfig->GetInt(TEXT("ConsoleVariables"), TEXT("r.MaxAnisotropy"), value, GEngineIni);
-	output.Anisotropic = value;
+int32 UGraphicsConfig::CommitGraphicsChanges()
+{
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_CommitGraphicsChanges);
 
-	GConfig->GetInt(TEXT("ConsoleVariables"), TEXT("r.PostProcessAAQuality"), value, GEngineIni);
-	switch (value)
+	if (GraphicsBatchDepth <= 0)
 	{
-	case 0:
-	default:
-		output.Antialiasing = EQuality::Off;
-		break;
-	case 1:
-		output.Antialiasing = EQuality::Low;
-		break;
-	case 2:
-		output.Antialiasing = EQuality::Medium;
-		break;
-	case 3:
-		output.Antialiasing = EQuality::High;
-		break;
-	case 4:
-		output.Antialiasing = EQuality::Ultra;
+		return 0;
 	}
 
-	GConfig->GetInt(TEXT("ConsoleVariables"), TEXT("sg.ShadowQuality"), value, GEngineIni);
-	switch (value)
+	GraphicsBatchDepth--;
+
+	//only the outermost commit writes to disk
+	if (GraphicsBatchDepth > 0)
 	{
-	case 0:
-	default:
-		output.Shadows = EQuality::Off;
-		break;
-	case 1:
-		output.Shadows = EQuality::Low;
-		break;
-	case 2:
-		output.Shadows = EQuality::Medium;
-		break;
-	case 3:
-		output.Shadows = EQuality::High;
+		return 0;
 	}
 
-	GConfig->GetInt(TEXT("ConsoleVariables"), TEXT("r.AmbientOcclusionLevels"), value, GEngineIni);
-	switch (value)
+	int32 flushCount = PendingFlushes.Num();
+
+	for (const FString& filename : PendingFlushes)
 	{
-	case 0:
-	default:
-		output.SSAO = EQuality::Off;
-		break;
-	case 1:
-		output.SSAO = EQuality::Low;
-		break;
-	case 2:
-		output.SSAO = EQuality::Medium;
-		break;
-	case 3:
-		output.SSAO = EQuality::High;
+		IConfigBackend::Get().QueueWrite(filename);
 	}
 
-	GConfig->GetInt(TEXT("ConsoleVariables"), TEXT("r.SSR.Quality"), value, GEngineIni);
-	switch (value)
+	PendingFlushes.Empty();
+
+	ApplyPendingCVars();
+
+	FConfigSnapshot::PublishCurrent();
+
+	return flushCount;
+}
+
+EGraphicsApply UGraphicsConfig::GetPendingGraphicsApply()
+{
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_GetPendingGraphicsApply);
+
+	if (RestartCVars.Num() > 0)
 	{
-	case 0:
-	default:
-		output.Reflections = EQuality::Off;
-		break;
-	case 1:
-		output.Reflections = EQuality::Low;
-		break;
-	case 2:
-		output.Reflections = EQuality::Medium;
-		break;
-	case 3:
-		output.Reflections = EQuality::High;
+		return EGraphicsApply::Restart;
 	}
-
-	GConfig->GetInt(TEXT("ConsoleVariables"), TEXT("r.MotionBlurQuality"), value, GEngineIni);
-	switch (value)
+	else if (NextLevelCVars.Num() > 0)
 	{
-	case 0:
-	default:
-		output.MotionBlur = EQuality::Off;
-		break;
-	case 1:
-		output.MotionBlur = EQuality::Low;
-		break;
-	case 2:
-		output.MotionBlur = EQuality::Medium;
-		break;
-	case 3:
-		output.MotionBlur = EQuality::High;
+		return EGraphicsApply::NextLevel;
 	}
-
-	GConfig->GetInt(TEXT("ConsoleVariables"), TEXT("r.LensFlareQuality"), value, GEngineIni);
-	switch (value)
+	else
 	{
-	case 0:
-	default:
-		output.LensFlare = EQuality::Off;
-		break;
-	case 1:
-		output.LensFlare = EQuality::Low;
-		break;
-	case 2:
-		output.LensFlare = EQuality::Medium;
-		break;
-	case 3:
-		output.LensFlare = EQuality::High;
+		return EGraphicsApply::Instant;
 	}
+}
+
+int32 UGraphicsConfig::ApplyGraphicsSettings(const FGraphicsSettings& settings)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_ApplyGraphicsSettings);
+
+	int32 changed = DiffGraphicsSettings(GetGraphicsSettings(), settings);
+
+	BeginGraphicsChanges();
 
-	GConfig->GetInt(TEXT("ConsoleVariables"), TEXT("r.BloomQuality"), value, GEngineIni);
-	switch (value)
+	for (const FGraphicsSettingDescriptor& desc : GraphicsSettingDescriptors)
 	{
-	case 0:
-	default:
-		output.Bloom = EQuality::Off;
-		break;
-	case 1:
-		output.Bloom = EQuality::Low;
-		break;
-	case 2:
-		output.Bloom = EQuality::Medium;
-		break;
-	case 3:
-		output.Bloom = EQuality::High;
-		break;
-	case 4:
-		output.Bloom = EQuality::Ultra;
+		if (changed & (1 << (int32)desc.Setting))
+		{
+			SetGraphicsSetting(desc.Setting, desc.Get(settings));
+		}
 	}
 
-	GConfig->GetBool(TEXT("ConsoleVariables"), TEXT("r.SimpleDynamicLighting"), bVal, GEngineIni);
-	if (bVal)
+	return CommitGraphicsChanges();
+}
+
+static const TCHAR* DetectionSection = TEXT("ExtraConfig.HardwareDetection");
+
+FRecommendedSettings UGraphicsConfig::DetectRecommendedPreset(bool force)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_DetectRecommendedPreset);
+
+	FRecommendedSettings result;
+	FHardwareSurvey survey = FHardwareDetection::Survey();
+	uint32 fingerprint = FHardwareDetection::Fingerprint(survey);
+
+	result.Cores = survey.Cores;
+	result.MemoryMB = survey.TotalMemoryMB;
+
+	int32 cachedFingerprint = 0;
+	if (!force && GetConfigInt(DetectionSection, TEXT("Fingerprint"), cachedFingerprint, GGameUserSettingsIni) && (uint32)cachedFingerprint == fingerprint)
 	{
-		output.SimpleLighting = 1;
+		int32 preset = (int32)EQuality::Medium;
+		GetConfigInt(DetectionSection, TEXT("Preset"), preset, GGameUserSettingsIni);
+		GetConfigFloat(DetectionSection, TEXT("CPUScore"), result.CPUScore, GGameUserSettingsIni);
+		result.Preset = (EQuality)FMath::Clamp(preset, (int32)EQuality::Off, (int32)EQuality::Ultra);
+		result.Settings = FHardwareDetection::MakePresetSettings(result.Preset);
+
+		for (const FGraphicsSettingDescriptor& desc : GraphicsSettingDescriptors)
+		{
+			int32 value;
+			if (GetConfigInt(DetectionSection, desc.CVarName, value, GGameUserSettingsIni))
+			{
+				desc.Set(result.Settings, desc.Clamp(value));
+			}
+		}
+
+		return result;
 	}
-	else
+
+	survey.CPUScore = FHardwareDetection::RunCPUBenchmark();
+
+	result.CPUScore = survey.CPUScore;
+	result.Preset = FHardwareDetection::Recommend(survey, result.Settings);
+
+	UE_LOG(LogExtraConfig, Log, TEXT("Detected preset %d: cpu score %.1f, %d cores, %d MB, gpu '%s'"),
+		(int32)result.Preset, survey.CPUScore, survey.Cores, survey.TotalMemoryMB, *survey.GPUBrand);
+
+	SetConfigInt(DetectionSection, TEXT("Fingerprint"), (int32)fingerprint, GGameUserSettingsIni);
+	SetConfigInt(DetectionSection, TEXT("Preset"), (int32)result.Preset, GGameUserSettingsIni);
+	SetConfigFloat(DetectionSection, TEXT("CPUScore"), result.CPUScore, GGameUserSettingsIni);
+
+	for (const FGraphicsSettingDescriptor& desc : GraphicsSettingDescriptors)
 	{
-		output.SimpleLighting = 0;
+		SetConfigInt(DetectionSection, desc.CVarName, desc.Get(result.Settings), GGameUserSettingsIni);
 	}
 
-	return output;
+	FlushConfig(GGameUserSettingsIni);
+
+	return result;
 }
 
-void UGraphicsConfig::ToggleVSync(bool vSync)
+bool UGraphicsConfig::ApplyRecommendedPresetOnFirstLaunch()
 {
-	int32 intVSync;
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_ApplyRecommendedPresetOnFirstLaunch);
 
-	if (vSync)
+	FString fingerprint;
+	if (GetGraphicsPreset() != EQuality::Off || IConfigBackend::Get().GetString(DetectionSection, TEXT("Fingerprint"), fingerprint, GGameUserSettingsIni))
 	{
-		intVSync = 1;
+		return false;
 	}
-	else
+
+	FRecommendedSettings recommended = DetectRecommendedPreset(false);
+
+	BeginGraphicsChanges();
+	SetGraphicsPreset(recommended.Preset);
+	ApplyGraphicsSettings(recommended.Settings);
+	CommitGraphicsChanges();
+
+	UE_LOG(LogExtraConfig, Log, TEXT("First launch, applied recommended preset %d"), (int32)recommended.Preset);
+
+	return true;
+}
+
+FGraphicsSettings UGraphicsConfig::GetGraphicsSettings()
+{
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_GetGraphicsSettings);
+
+	if (!bCachedSettingsValid)
 	{
-		intVSync = 0;
+		CachedSettings = ReadGraphicsSettingsFromConfig();
+		bCachedSettingsValid = true;
 	}
 
-	GConfig->SetInt(TEXT("ConsoleVariables"), TEXT("r.VSync"), intVSync, GEngineIni);
+	return CachedSettings;
+}
+
+int32 UGraphicsConfig::GetGraphicsSettingsGeneration()
+{
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_GetGraphicsSettingsGeneration);
 
-	GConfig->Flush(false, GEngineIni);
+	return SettingsGeneration;
 }
 
-void UGraphicsConfig::SetAnisotropic(int32 af)
+void UGraphicsConfig::InvalidateGraphicsSettings()
 {
-	GConfig->SetInt(TEXT("ConsoleVariables"), TEXT("r.MaxAnisotropy"), af, GEngineIni);
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_InvalidateGraphicsSettings);
 
-	GConfig->Flush(false, GEngineIni);
+	bCachedSettingsValid = false;
+	SettingsGeneration++;
 }
 
-void UGraphicsConfig::SetAntialiasing(EQuality aa)
+void UGraphicsConfig::PrimeGraphicsSettings(const FGraphicsSettings& settings)
 {
-	int32 intAA;
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_PrimeGraphicsSettings);
+
+	CachedSettings = settings;
+	bCachedSettingsValid = true;
+	SettingsGeneration++;
+}
 
-	switch (aa)
+//Console variable sinks run on the game thread after any console variable changed, which includes
+//the engine applying [ConsoleVariables] again after the ini was reloaded. The setters keep the cache
+//in step with the ini, so only a reload or an edit from outside the plugin makes this reach the update.
+static void OnConsoleVariablesChanged()
+{
+	if (!bCachedSettingsValid)
 	{
-	case EQuality::Off:
-		intAA = 0;
-		break;
-	case EQuality::Low:
-		intAA = 1;
-		break;
-	case EQuality::Medium:
-		intAA = 2;
-		break;
-	default:
-	case EQuality::High:
-		intAA = 3;
-		break;
-	case EQuality::Ultra:
-		intAA = 4;
+		return;
 	}
 
-	GConfig->SetInt(TEXT("ConsoleVariables"), TEXT("r.PostProcessAAQuality"), intAA, GEngineIni);
+	FGraphicsSettings current = UGraphicsConfig::ReadGraphicsSettingsFromConfig();
+	int32 changed = UGraphicsConfig::DiffGraphicsSettings(current, CachedSettings);
 
-	GConfig->Flush(false, GEngineIni);
+	if (changed != 0)
+	{
+		UGraphicsConfig::PrimeGraphicsSettings(current);
+		FConfigSnapshot::PublishCurrent();
+		UConfigNotifications::MarkChanged(0, changed);
+	}
 }
 
-void UGraphicsConfig::SetShadowQuality(EQuality shadow)
+static FAutoConsoleVariableSink GraphicsSettingsSink(FConsoleCommandDelegate::CreateStatic(&OnConsoleVariablesChanged));
+
+FGraphicsSettings UGraphicsConfig::ReadGraphicsSettingsFromConfig()
 {
-	int32 intShadow;
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_ReadGraphicsSettingsFromConfig);
+
+	FGraphicsSettings output;
+	IConfigBackend& backend = IConfigBackend::Get();
 
-	switch (shadow)
+	for (const FGraphicsSettingDescriptor& desc : GraphicsSettingDescriptors)
 	{
-	case EQuality::Off:
-		intShadow = 0;
-		break;
-	case EQuality::Low:
-		intShadow = 1;
-		break;
-	default:
-	case EQuality::Medium:
-		intShadow = 2;
-		break;
-	case EQuality::High:
-		intShadow = 3;
+		int32 value = desc.DefaultValue;
+		FString text;
+
+		if (backend.GetString(TEXT("ConsoleVariables"), desc.CVarName, text, GEngineIni))
+		{
+			//bool settings may have been written as True/False by hand
+			value = text.IsNumeric() ? FCString::Atoi(*text) : (FCString::ToBool(*text) ? 1 : 0);
+		}
+		else
+		{
+			backend.GetCVar(desc.CVarName, value);
+		}
+
+		desc.Set(output, desc.Clamp(value));
 	}
 
-	GConfig->SetInt(TEXT("ConsoleVariables"), TEXT("sg.ShadowQuality"), intShadow, GEngineIni);
-
-	GConfig->Flush(false, GEngineIni);
+	return output;
 }
 
-void UGraphicsConfig::SetAmbientOcclusion(EQuality ao)
+int32 UGraphicsConfig::GetGraphicsSetting(EGraphicsSetting setting)
 {
-	int32 intAO;
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_GetGraphicsSetting);
 
-	switch (ao)
+	if (setting >= EGraphicsSetting::MAX)
 	{
-	case EQuality::Off:
-		intAO = 0;
-		break;
-	case EQuality::Low:
-		intAO = 1;
-		break;
-	default:
-	case EQuality::Medium:
-		intAO = 2;
-		break;
-	case EQuality::High:
-		intAO = 3;
+		return 0;
 	}
 
-	GConfig->SetInt(TEXT("ConsoleVariables"), TEXT("r.AmbientOcclusionLevels"), intAO, GEngineIni);
-
-	GConfig->Flush(false, GEngineIni);
+	return GetGraphicsSettingDescriptor(setting).Get(GetGraphicsSettings());
 }
 
-void UGraphicsConfig::SetReflections(EQuality ssr)
+void UGraphicsConfig::SetGraphicsSetting(EGraphicsSetting setting, int32 value)
 {
-	int32 intSSR;
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_SetGraphicsSetting);
 
-	switch (ssr)
+	if (setting >= EGraphicsSetting::MAX)
 	{
-	case EQuality::Off:
-		intSSR = 0;
-		break;
-	case EQuality::Low:
-		intSSR = 1;
-		break;
-	default:
-	case EQuality::Medium:
-		intSSR = 2;
-		break;
-	case EQuality::High:
-		intSSR = 3;
+		return;
+	}
+
+	const FGraphicsSettingDescriptor& desc = GetGraphicsSettingDescriptor(setting);
+	value = desc.Clamp(value);
+
+	if (desc.Get(GetGraphicsSettings()) != value)
+	{
+		UConfigNotifications::MarkChanged(0, 1 << (int32)setting);
 	}
 
-	GConfig->SetInt(TEXT("ConsoleVariables"), TEXT("r.SSR.Quality"), intSSR, GEngineIni);
+	UE_LOG(LogExtraConfig, Verbose, TEXT("Setting %s = %d"), desc.CVarName, value);
+
+	SetConsoleVariable(desc.CVarName, value, desc.Apply, desc.bRecreateRenderState);
 
-	GConfig->Flush(false, GEngineIni);
+	desc.Set(CachedSettings, value);
+	SettingsGeneration++;
+
+	FlushConfig(GEngineIni);
 }
 
-void UGraphicsConfig::SetMotionBlur(EQuality blur)
+EGraphicsApply UGraphicsConfig::GetGraphicsSettingApply(EGraphicsSetting setting)
 {
-	int32 intBlur;
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_GetGraphicsSettingApply);
 
-	switch (blur)
+	if (setting >= EGraphicsSetting::MAX)
 	{
-	default:
-	case EQuality::Off:
-		intBlur = 0;
-		break;
-	case EQuality::Low:
-		intBlur = 1;
-		break;
-	case EQuality::Medium:
-		intBlur = 2;
-		break;
-	case EQuality::High:
-		intBlur = 3;
+		return EGraphicsApply::Instant;
 	}
 
-	GConfig->SetInt(TEXT("ConsoleVariables"), TEXT("r.MotionBlurQuality"), intBlur, GEngineIni);
-
-	GConfig->Flush(false, GEngineIni);
+	return GetGraphicsSettingDescriptor(setting).Apply;
 }
 
-void UGraphicsConfig::SetLensFlare(EQuality lensFlare)
+int32 UGraphicsConfig::DiffGraphicsSettings(const FGraphicsSettings& a, const FGraphicsSettings& b)
 {
-	int32 intFlare;
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_DiffGraphicsSettings);
+
+	int32 changed = 0;
 
-	switch (lensFlare)
+	for (const FGraphicsSettingDescriptor& desc : GraphicsSettingDescriptors)
 	{
-	default:
-	case EQuality::Off:
-		intFlare = 0;
-		break;
-	case EQuality::Low:
-		intFlare = 1;
-		break;
-	case EQuality::Medium:
-		intFlare = 2;
-		break;
-	case EQuality::High:
-		intFlare = 3;
+		if (desc.Get(a) != desc.Get(b))
+		{
+			changed |= 1 << (int32)desc.Setting;
+		}
 	}
 
-	GConfig->SetInt(TEXT("ConsoleVariables"), TEXT("r.LensFlareQuality"), intFlare, GEngineIni);
+	return changed;
+}
+
+void UGraphicsConfig::ToggleVSync(bool vSync)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_ToggleVSync);
 
-	GConfig->Flush(false, GEngineIni);
+	SetGraphicsSetting(EGraphicsSetting::VSync, vSync);
 }
 
-void UGraphicsConfig::SetBloom(EQuality bloom)
+void UGraphicsConfig::SetAnisotropic(int32 af)
 {
-	int32 intBloom;
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_SetAnisotropic);
 
-	switch (bloom)
-	{
-	default:
-	case EQuality::Off:
-		intBloom = 0;
-		break;
-	case EQuality::Low:
-		intBloom = 1;
-		break;
-	case EQuality::Medium:
-		intBloom = 2;
-		break;
-	case EQuality::High:
-		intBloom = 3;
-		break;
-	case EQuality::Ultra:
-		intBloom = 4;
-	}
+	SetGraphicsSetting(EGraphicsSetting::Anisotropic, af);
+}
+
+void UGraphicsConfig::SetAntialiasing(EQuality aa)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_SetAntialiasing);
+
+	SetGraphicsSetting(EGraphicsSetting::Antialiasing, (int32)aa);
+}
+
+void UGraphicsConfig::SetShadowQuality(EQuality shadow)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_SetShadowQuality);
+
+	SetGraphicsSetting(EGraphicsSetting::Shadows, (int32)shadow);
+}
+
+void UGraphicsConfig::SetAmbientOcclusion(EQuality ao)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_SetAmbientOcclusion);
+
+	SetGraphicsSetting(EGraphicsSetting::SSAO, (int32)ao);
+}
+
+void UGraphicsConfig::SetReflections(EQuality ssr)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_SetReflections);
+
+	SetGraphicsSetting(EGraphicsSetting::Reflections, (int32)ssr);
+}
+
+void UGraphicsConfig::SetMotionBlur(EQuality blur)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_SetMotionBlur);
+
+	SetGraphicsSetting(EGraphicsSetting::MotionBlur, (int32)blur);
+}
 
-	GConfig->SetInt(TEXT("ConsoleVariables"), TEXT("r.BloomQuality"), intBloom, GEngineIni);
+void UGraphicsConfig::SetLensFlare(EQuality lensFlare)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_SetLensFlare);
 
-	GConfig->Flush(false, GEngineIni);
+	SetGraphicsSetting(EGraphicsSetting::LensFlare, (int32)lensFlare);
+}
+
+void UGraphicsConfig::SetBloom(EQuality bloom)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_SetBloom);
+
+	SetGraphicsSetting(EGraphicsSetting::Bloom, (int32)bloom);
 }
 
 void UGraphicsConfig::ToggleSimpleLighting(bool simple)
 {
-	int32 intSimple;
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_ToggleSimpleLighting);
+
+	SetGraphicsSetting(EGraphicsSetting::SimpleLighting, simple);
+}
+
+void UGraphicsConfig::SetViewDistanceQuality(EQuality viewDistance)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_SetViewDistanceQuality);
 
-	if (simple)
+	SetGraphicsSetting(EGraphicsSetting::ViewDistance, (int32)viewDistance);
+}
+
+void UGraphicsConfig::SetTextureQuality(EQuality textures)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_SetTextureQuality);
+
+	SetGraphicsSetting(EGraphicsSetting::Textures, (int32)textures);
+}
+
+void UGraphicsConfig::SetEffectsQuality(EQuality effects)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_SetEffectsQuality);
+
+	SetGraphicsSetting(EGraphicsSetting::Effects, (int32)effects);
+}
+
+void UGraphicsConfig::SetPostProcessQuality(EQuality postProcess)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_SetPostProcessQuality);
+
+	SetGraphicsSetting(EGraphicsSetting::PostProcess, (int32)postProcess);
+}
+
+void UGraphicsConfig::SetFoliageQuality(EQuality foliage)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_SetFoliageQuality);
+
+	SetGraphicsSetting(EGraphicsSetting::Foliage, (int32)foliage);
+}
+
+// ---------
+// Benchmark
+// ---------
+
+static void BenchGraphicsSettings(const TArray<FString>& args)
+{
+	int32 iterations = args.Num() > 0 ? FCString::Atoi(*args[0]) : 10000;
+	iterations = FMath::Max(iterations, 1);
+
+	double start = FPlatformTime::Seconds();
+	for (int32 i = 0; i < iterations; i++)
 	{
-		intSimple = 1;
+		UGraphicsConfig::ReadGraphicsSettingsFromConfig();
 	}
-	else
+	double uncached = FPlatformTime::Seconds() - start;
+
+	UGraphicsConfig::GetGraphicsSettings();
+
+	start = FPlatformTime::Seconds();
+	for (int32 i = 0; i < iterations; i++)
 	{
-		intSimple = 0;
+		UGraphicsConfig::GetGraphicsSettings();
 	}
+	double cached = FPlatformTime::Seconds() - start;
 
-	GConfig->SetInt(TEXT("ConsoleVariables"), TEXT("r.SimpleDynamicLighting"), intSimple, GEngineIni);
-
-	GConfig->Flush(false, GEngineIni);
+	UE_LOG(LogExtraConfig, Display, TEXT("GetGraphicsSettings x%d: uncached %.3f us/call, cached %.3f us/call"),
+		iterations, uncached * 1000000.0 / iterations, cached * 1000000.0 / iterations);
 }
+
+static FAutoConsoleCommand BenchGraphicsSettingsCommand(
+	TEXT("ExtraConfig.BenchGraphicsSettings"),
+	TEXT("Times cached and uncached GetGraphicsSettings reads. Optional argument: iteration count."),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&BenchGraphicsSettings));
@@ -0,0 +1,67 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "GraphicsConfig.h"
+
+/**
+ * One row per EGraphicsSetting: which console variable backs the FGraphicsSettings field, the
+ * range it accepts and when a change takes effect. Get, set, batching, caching and diffing in
+ * UGraphicsConfig are all driven from this table, so a new setting only needs a new row.
+ */
+struct FGraphicsSettingDescriptor
+{
+	EGraphicsSetting Setting;
+	const TCHAR* CVarName;
+	int32 MinValue;
+	int32 MaxValue;
+	//used when neither the ini nor the console variable manager has a value
+	int32 DefaultValue;
+	EGraphicsApply Apply;
+	bool bRecreateRenderState;
+
+	int32 (*Get)(const FGraphicsSettings& settings);
+	void (*Set)(FGraphicsSettings& settings, int32 value);
+
+	int32 Clamp(int32 value) const
+	{
+		return FMath::Clamp(value, MinValue, MaxValue);
+	}
+};
+
+//Every field is stored as an int32; EQuality maps Off..Ultra to 0..4 and is clamped to the cvar range
+inline int32 ToGraphicsValue(bool value) { return value ? 1 : 0; }
+inline int32 ToGraphicsValue(int32 value) { return value; }
+inline int32 ToGraphicsValue(EQuality value) { return (int32)value; }
+
+inline void FromGraphicsValue(bool& out, int32 value) { out = value != 0; }
+inline void FromGraphicsValue(int32& out, int32 value) { out = value; }
+inline void FromGraphicsValue(EQuality& out, int32 value) { out = (EQuality)FMath::Clamp(value, (int32)EQuality::Off, (int32)EQuality::Ultra); }
+
+template<typename FieldType, FieldType FGraphicsSettings::*Field>
+struct TGraphicsSettingField
+{
+	static int32 Get(const FGraphicsSettings& settings)
+	{
+		return ToGraphicsValue(settings.*Field);
+	}
+
+	static void Set(FGraphicsSettings& settings, int32 value)
+	{
+		FromGraphicsValue(settings.*Field, value);
+	}
+};
+
+#define GRAPHICS_SETTING_FIELD(Name) \
+	&TGraphicsSettingField<decltype(FGraphicsSettings::Name), &FGraphicsSettings::Name>::Get, \
+	&TGraphicsSettingField<decltype(FGraphicsSettings::Name), &FGraphicsSettings::Name>::Set
+
+/** Indexed by EGraphicsSetting. */
+extern const FGraphicsSettingDescriptor GraphicsSettingDescriptors[(int32)EGraphicsSetting::MAX];
+
+inline const FGraphicsSettingDescriptor& GetGraphicsSettingDescriptor(EGraphicsSetting setting)
+{
+	const FGraphicsSettingDescriptor& desc = GraphicsSettingDescriptors[(int32)setting];
+	checkSlow(desc.Setting == setting);
+	return desc;
+}
@@ -0,0 +1,157 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ExtraConfigPrivatePCH.h"
+#include "HardwareDetection.h"
+#include "GraphicsSettingDescriptors.h"
+#include "RHI.h"
+
+//Seconds the benchmark workload takes on the reference machine
+static const double ReferenceBenchmarkSeconds = 0.02;
+
+static const uint32 IntelVendorId = 0x8086;
+
+static EQuality MinQuality(EQuality a, EQuality b)
+{
+	return (uint8)a < (uint8)b ? a : b;
+}
+
+static EQuality LowerQuality(EQuality quality)
+{
+	return quality == EQuality::Off ? EQuality::Off : (EQuality)((uint8)quality - 1);
+}
+
+float FHardwareDetection::RunCPUBenchmark()
+{
+	double best = DBL_MAX;
+
+	for (int32 run = 0; run < 3; run++)
+	{
+		double start = FPlatformTime::Seconds();
+
+		uint32 state = 12345;
+		float accumulator = 0.f;
+		for (int32 i = 0; i < 2000000; i++)
+		{
+			state = state * 1664525u + 1013904223u;
+			accumulator += FMath::Sqrt((float)(state >> 8)) * 0.5f;
+		}
+
+		double elapsed = FPlatformTime::Seconds() - start;
+
+		//keep the loop from being optimised out
+		if (accumulator < 0.f)
+		{
+			elapsed += 1.0;
+		}
+
+		best = FMath::Min(best, elapsed);
+	}
+
+	return (float)(ReferenceBenchmarkSeconds / FMath::Max(best, 0.000001) * 100.0);
+}
+
+FHardwareSurvey FHardwareDetection::Survey()
+{
+	FHardwareSurvey survey;
+
+	survey.Cores = FPlatformMisc::NumberOfCores();
+	survey.LogicalCores = FPlatformMisc::NumberOfCoresIncludingHyperthreads();
+
+	FPlatformMemoryStats stats = FPlatformMemory::GetStats();
+	survey.TotalMemoryMB = (int32)(stats.TotalPhysical / (1024 * 1024));
+	survey.AvailableMemoryMB = (int32)(stats.AvailablePhysical / (1024 * 1024));
+
+	survey.CPUBrand = FPlatformMisc::GetCPUBrand().Trim().TrimTrailing();
+	survey.GPUBrand = FPlatformMisc::GetPrimaryGPUBrand().Trim().TrimTrailing();
+	survey.GPUVendorId = GRHIVendorId;
+
+	return survey;
+}
+
+uint32 FHardwareDetection::Fingerprint(const FHardwareSurvey& survey)
+{
+	//memory rounded to the nearest GB so small reservations by the OS don't change the fingerprint
+	FString key = FString::Printf(TEXT("%s|%s|%u|%d|%d|%d"), *survey.CPUBrand, *survey.GPUBrand, survey.GPUVendorId,
+		survey.Cores, survey.LogicalCores, (survey.TotalMemoryMB + 512) / 1024);
+
+	return FCrc::StrCrc32(*key);
+}
+
+EQuality FHardwareDetection::GetCPUTier(float cpuScore)
+{
+	return cpuScore < 60.f ? EQuality::Low : cpuScore < 100.f ? EQuality::Medium : cpuScore < 160.f ? EQuality::High : EQuality::Ultra;
+}
+
+EQuality FHardwareDetection::GetMemoryTier(int32 totalMemoryMB)
+{
+	int32 memoryGB = (totalMemoryMB + 512) / 1024;
+	return memoryGB < 6 ? EQuality::Low : memoryGB < 10 ? EQuality::Medium : memoryGB < 16 ? EQuality::High : EQuality::Ultra;
+}
+
+EQuality FHardwareDetection::GetCoreTier(int32 cores)
+{
+	return cores <= 2 ? EQuality::Low : cores <= 4 ? EQuality::High : EQuality::Ultra;
+}
+
+EQuality FHardwareDetection::GetGPUTier(uint32 gpuVendorId)
+{
+	//integrated graphics; no vendor means no RHI (headless), which doesn't constrain the preset
+	return gpuVendorId == IntelVendorId ? EQuality::Low : EQuality::Ultra;
+}
+
+EQuality FHardwareDetection::Recommend(const FHardwareSurvey& survey, FGraphicsSettings& outSettings)
+{
+	EQuality cpu = GetCPUTier(survey.CPUScore);
+	EQuality memory = GetMemoryTier(survey.TotalMemoryMB);
+	EQuality cores = GetCoreTier(survey.Cores);
+	EQuality gpu = GetGPUTier(survey.GPUVendorId);
+
+	//the preset is the lowest tier, so compare each component with the others rather than with it
+	EQuality others = MinQuality(MinQuality(cpu, cores), gpu);
+	EQuality preset = MinQuality(memory, others);
+
+	outSettings = MakePresetSettings(preset);
+
+	//overrides for the component that is specifically short
+	if (memory < others || survey.AvailableMemoryMB < 2048)
+	{
+		outSettings.Textures = LowerQuality(outSettings.Textures);
+	}
+
+	if (cpu < EQuality::High)
+	{
+		outSettings.ViewDistance = LowerQuality(outSettings.ViewDistance);
+		outSettings.Foliage = LowerQuality(outSettings.Foliage);
+	}
+
+	if (survey.LogicalCores <= 2)
+	{
+		outSettings.Effects = LowerQuality(outSettings.Effects);
+	}
+
+	if (gpu == EQuality::Low)
+	{
+		outSettings.SSAO = EQuality::Off;
+		outSettings.Reflections = EQuality::Off;
+	}
+
+	return preset;
+}
+
+FGraphicsSettings FHardwareDetection::MakePresetSettings(EQuality preset)
+{
+	FGraphicsSettings settings;
+
+	for (const FGraphicsSettingDescriptor& desc : GraphicsSettingDescriptors)
+	{
+		desc.Set(settings, desc.Clamp((int32)preset));
+	}
+
+	//the non-quality fields
+	static const int32 Anisotropy[] = { 0, 2, 4, 8, 16 };
+	settings.Anisotropic = Anisotropy[(int32)preset];
+	settings.VSync = false;
+	settings.SimpleLighting = false;
+
+	return settings;
+}
@@ -0,0 +1,51 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "GraphicsConfig.h"
+
+struct FHardwareSurvey
+{
+	//100 is the reference machine; higher is faster
+	float CPUScore;
+	int32 Cores;
+	int32 LogicalCores;
+	int32 TotalMemoryMB;
+	int32 AvailableMemoryMB;
+	FString CPUBrand;
+	FString GPUBrand;
+	uint32 GPUVendorId;
+
+	FHardwareSurvey() : CPUScore(0.f), Cores(0), LogicalCores(0), TotalMemoryMB(0), AvailableMemoryMB(0), GPUVendorId(0) {}
+};
+
+/**
+ * Hardware survey behind UGraphicsConfig::DetectRecommendedPreset. The CPU benchmark, memory and
+ * core counts only use platform abstractions and work on a headless box; GPU information is added
+ * when an RHI is up and ignored otherwise.
+ */
+class FHardwareDetection
+{
+public:
+
+	/** Times a fixed single-threaded integer and float workload, best of a few runs. */
+	static float RunCPUBenchmark();
+
+	/** Everything but the CPU score, which is only worth measuring when the fingerprint changed. */
+	static FHardwareSurvey Survey();
+
+	/** Stable across runs on the same machine; changes when the CPU, GPU, core count or installed memory change. */
+	static uint32 Fingerprint(const FHardwareSurvey& survey);
+
+	/** Preset each component supports on its own; Recommend takes the lowest. */
+	static EQuality GetCPUTier(float cpuScore);
+	static EQuality GetMemoryTier(int32 totalMemoryMB);
+	static EQuality GetCoreTier(int32 cores);
+	static EQuality GetGPUTier(uint32 gpuVendorId);
+
+	/** Picks the preset the weakest component supports and adjusts individual settings for specific bottlenecks. */
+	static EQuality Recommend(const FHardwareSurvey& survey, FGraphicsSettings& outSettings);
+
+	/** Every setting at the level of the preset. */
+	static FGraphicsSettings MakePresetSettings(EQuality preset);
+};
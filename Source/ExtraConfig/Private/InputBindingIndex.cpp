@@ -0,0 +1,337 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ExtraConfigPrivatePCH.h"
+#include "InputBindingIndex.h"
+#include "GameFramework/InputSettings.h"
+
+uint8 FInputBindingIndex::MakeModifiers(bool ctrl, bool shift, bool alt, bool cmd)
+{
+	return (shift ? Shift : 0) | (ctrl ? Ctrl : 0) | (alt ? Alt : 0) | (cmd ? Cmd : 0);
+}
+
+uint8 FInputBindingIndex::MakeModifiers(const FInputActionKeyMapping& mapping)
+{
+	return MakeModifiers(mapping.bCtrl, mapping.bShift, mapping.bAlt, mapping.bCmd);
+}
+
+int32 FInputBindingIndex::SettingsGeneration = 0;
+
+FInputBindingIndex& FInputBindingIndex::Get(const UInputSettings* settings)
+{
+	static FInputBindingIndex Instance;
+
+	if (!Instance.IsCurrent(settings))
+	{
+		Instance.Build(settings->ActionMappings, settings->AxisMappings);
+	}
+
+	return Instance;
+}
+
+void FInputBindingIndex::MarkSettingsChanged()
+{
+	SettingsGeneration++;
+}
+
+FInputBindingIndex::FInputBindingIndex()
+	: BuiltGeneration(0)
+	, NumActions(0)
+	, NumAxes(0)
+	, bBuilt(false)
+{
+}
+
+bool FInputBindingIndex::IsCurrent(const UInputSettings* settings) const
+{
+	//the counts are only a backstop for code outside the plugin that adds or removes mappings unannounced
+	return bBuilt && BuiltGeneration == SettingsGeneration
+		&& NumActions == settings->ActionMappings.Num() && NumAxes == settings->AxisMappings.Num();
+}
+
+void FInputBindingIndex::Build(const TArray<FInputActionKeyMapping>& actions, const TArray<FInputAxisKeyMapping>& axes)
+{
+	BindingsByKey.Reset();
+	ActionNames.Reset();
+	AxisNames.Reset();
+	ActionsByName.Reset();
+	AxesByName.Reset();
+
+	for (const FInputActionKeyMapping& mapping : actions)
+	{
+		BindingsByKey.FindOrAdd(mapping.Key).Add(FKeyBinding(mapping.ActionName, MakeModifiers(mapping), false, 0.f));
+		AddActionMap(mapping);
+	}
+
+	for (const FInputAxisKeyMapping& mapping : axes)
+	{
+		BindingsByKey.FindOrAdd(mapping.Key).Add(FKeyBinding(mapping.AxisName, 0, true, mapping.Scale));
+		AddAxisMap(mapping);
+	}
+
+	NumActions = actions.Num();
+	NumAxes = axes.Num();
+	BuiltGeneration = SettingsGeneration;
+	bBuilt = true;
+}
+
+void FInputBindingIndex::Invalidate()
+{
+	bBuilt = false;
+}
+
+void FInputBindingIndex::AddActionMap(const FInputActionKeyMapping& mapping)
+{
+	TArray<FActionMap>* maps = ActionsByName.Find(mapping.ActionName);
+	if (!maps)
+	{
+		ActionNames.Add(mapping.ActionName);
+		maps = &ActionsByName.Add(mapping.ActionName);
+	}
+
+	maps->Add(FActionMap(mapping.ActionName, mapping.Key, mapping.bShift, mapping.bCtrl, mapping.bAlt, mapping.bCmd));
+}
+
+void FInputBindingIndex::AddAxisMap(const FInputAxisKeyMapping& mapping)
+{
+	TArray<FAxisMap>* maps = AxesByName.Find(mapping.AxisName);
+	if (!maps)
+	{
+		AxisNames.Add(mapping.AxisName);
+		maps = &AxesByName.Add(mapping.AxisName);
+	}
+
+	maps->Add(FAxisMap(mapping.AxisName, mapping.Key, mapping.Scale));
+}
+
+const TArray<FActionMap>& FInputBindingIndex::GetActionMaps(FName actionName) const
+{
+	static const TArray<FActionMap> None;
+
+	const TArray<FActionMap>* maps = ActionsByName.Find(actionName);
+	return maps ? *maps : None;
+}
+
+const TArray<FAxisMap>& FInputBindingIndex::GetAxisMaps(FName axisName) const
+{
+	static const TArray<FAxisMap> None;
+
+	const TArray<FAxisMap>* maps = AxesByName.Find(axisName);
+	return maps ? *maps : None;
+}
+
+void FInputBindingIndex::AddAction(const FInputActionKeyMapping& mapping)
+{
+	TArray<FKeyBinding>& bindings = BindingsByKey.FindOrAdd(mapping.Key);
+	uint8 modifiers = MakeModifiers(mapping);
+
+	for (const FKeyBinding& binding : bindings)
+	{
+		if (!binding.bAxis && binding.Name == mapping.ActionName && binding.Modifiers == modifiers)
+		{
+			return;
+		}
+	}
+
+	bindings.Add(FKeyBinding(mapping.ActionName, modifiers, false, 0.f));
+	AddActionMap(mapping);
+	NumActions++;
+}
+
+void FInputBindingIndex::RemoveAction(const FInputActionKeyMapping& mapping)
+{
+	TArray<FKeyBinding>* bindings = BindingsByKey.Find(mapping.Key);
+	if (!bindings)
+	{
+		return;
+	}
+
+	uint8 modifiers = MakeModifiers(mapping);
+
+	for (int32 i = bindings->Num() - 1; i >= 0; i--)
+	{
+		const FKeyBinding& binding = (*bindings)[i];
+		if (!binding.bAxis && binding.Name == mapping.ActionName && binding.Modifiers == modifiers)
+		{
+			bindings->RemoveAtSwap(i);
+			NumActions--;
+		}
+	}
+
+	if (bindings->Num() == 0)
+	{
+		BindingsByKey.Remove(mapping.Key);
+	}
+
+	TArray<FActionMap>* maps = ActionsByName.Find(mapping.ActionName);
+	if (maps)
+	{
+		maps->RemoveAll([&](const FActionMap& map)
+		{
+			return map.Key == mapping.Key && map.Shift == mapping.bShift && map.Ctrl == mapping.bCtrl && map.Alt == mapping.bAlt && map.Cmd == mapping.bCmd;
+		});
+
+		if (maps->Num() == 0)
+		{
+			ActionsByName.Remove(mapping.ActionName);
+			ActionNames.Remove(mapping.ActionName);
+		}
+	}
+}
+
+void FInputBindingIndex::ModifyAction(FName actionName, const FKey& key, uint8 oldModifiers, uint8 newModifiers)
+{
+	TArray<FKeyBinding>* bindings = BindingsByKey.Find(key);
+	if (!bindings)
+	{
+		return;
+	}
+
+	for (FKeyBinding& binding : *bindings)
+	{
+		if (!binding.bAxis && binding.Name == actionName && binding.Modifiers == oldModifiers)
+		{
+			binding.Modifiers = newModifiers;
+			break;
+		}
+	}
+
+	TArray<FActionMap>* maps = ActionsByName.Find(actionName);
+	if (maps)
+	{
+		for (FActionMap& map : *maps)
+		{
+			if (map.Key == key && MakeModifiers(map.Ctrl, map.Shift, map.Alt, map.Cmd) == oldModifiers)
+			{
+				map.Shift = (newModifiers & Shift) != 0;
+				map.Ctrl = (newModifiers & Ctrl) != 0;
+				map.Alt = (newModifiers & Alt) != 0;
+				map.Cmd = (newModifiers & Cmd) != 0;
+				return;
+			}
+		}
+	}
+}
+
+void FInputBindingIndex::AddAxis(const FInputAxisKeyMapping& mapping)
+{
+	TArray<FKeyBinding>& bindings = BindingsByKey.FindOrAdd(mapping.Key);
+
+	for (const FKeyBinding& binding : bindings)
+	{
+		if (binding.bAxis && binding.Name == mapping.AxisName && binding.Scale == mapping.Scale)
+		{
+			return;
+		}
+	}
+
+	bindings.Add(FKeyBinding(mapping.AxisName, 0, true, mapping.Scale));
+	AddAxisMap(mapping);
+	NumAxes++;
+}
+
+void FInputBindingIndex::RemoveAxis(const FInputAxisKeyMapping& mapping)
+{
+	TArray<FKeyBinding>* bindings = BindingsByKey.Find(mapping.Key);
+	if (!bindings)
+	{
+		return;
+	}
+
+	for (int32 i = bindings->Num() - 1; i >= 0; i--)
+	{
+		const FKeyBinding& binding = (*bindings)[i];
+		if (binding.bAxis && binding.Name == mapping.AxisName && binding.Scale == mapping.Scale)
+		{
+			bindings->RemoveAtSwap(i);
+			NumAxes--;
+		}
+	}
+
+	if (bindings->Num() == 0)
+	{
+		BindingsByKey.Remove(mapping.Key);
+	}
+
+	TArray<FAxisMap>* maps = AxesByName.Find(mapping.AxisName);
+	if (maps)
+	{
+		maps->RemoveAll([&](const FAxisMap& map)
+		{
+			return map.Key == mapping.Key && map.Scale == mapping.Scale;
+		});
+
+		if (maps->Num() == 0)
+		{
+			AxesByName.Remove(mapping.AxisName);
+			AxisNames.Remove(mapping.AxisName);
+		}
+	}
+}
+
+void FInputBindingIndex::ModifyAxis(FName axisName, const FKey& key, float oldScale, float newScale)
+{
+	TArray<FKeyBinding>* bindings = BindingsByKey.Find(key);
+	if (!bindings)
+	{
+		return;
+	}
+
+	for (FKeyBinding& binding : *bindings)
+	{
+		if (binding.bAxis && binding.Name == axisName && binding.Scale == oldScale)
+		{
+			binding.Scale = newScale;
+			break;
+		}
+	}
+
+	TArray<FAxisMap>* maps = AxesByName.Find(axisName);
+	if (maps)
+	{
+		for (FAxisMap& map : *maps)
+		{
+			if (map.Key == key && map.Scale == oldScale)
+			{
+				map.Scale = newScale;
+				return;
+			}
+		}
+	}
+}
+
+bool FInputBindingIndex::IsBoundToOther(const FKey& key, FName requestedBind) const
+{
+	const TArray<FKeyBinding>* bindings = BindingsByKey.Find(key);
+	if (!bindings)
+	{
+		return false;
+	}
+
+	for (const FKeyBinding& binding : *bindings)
+	{
+		if (binding.Name != requestedBind)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void FInputBindingIndex::GetConflicts(const FKey& key, uint8 modifiers, TArray<FName>& outNames) const
+{
+	const TArray<FKeyBinding>* bindings = BindingsByKey.Find(key);
+	if (!bindings)
+	{
+		return;
+	}
+
+	for (const FKeyBinding& binding : *bindings)
+	{
+		uint8 shared = binding.Modifiers & modifiers;
+		if (binding.bAxis || shared == binding.Modifiers || shared == modifiers)
+		{
+			outNames.AddUnique(binding.Name);
+		}
+	}
+}
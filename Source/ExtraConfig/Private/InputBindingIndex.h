@@ -0,0 +1,119 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "GameFramework/PlayerInput.h"
+#include "InputConfig.h"
+
+struct FKeyBinding
+{
+	FName Name;
+	//FInputBindingIndex::EModifier bits; always 0 for axes
+	uint8 Modifiers;
+	bool bAxis;
+	float Scale;
+
+	FKeyBinding(FName name, uint8 modifiers, bool bInAxis, float scale) :
+		Name(name), Modifiers(modifiers), bAxis(bInAxis), Scale(scale)
+	{}
+};
+
+//TSet key funcs matching mappings by their operator==, for set differences over whole mapping arrays
+struct FActionMappingKeyFuncs : BaseKeyFuncs<FInputActionKeyMapping, FInputActionKeyMapping>
+{
+	static const FInputActionKeyMapping& GetSetKey(const FInputActionKeyMapping& element) { return element; }
+	static bool Matches(const FInputActionKeyMapping& a, const FInputActionKeyMapping& b) { return a == b; }
+	static uint32 GetKeyHash(const FInputActionKeyMapping& mapping) { return HashCombine(GetTypeHash(mapping.ActionName), GetTypeHash(mapping.Key)); }
+};
+
+struct FAxisMappingKeyFuncs : BaseKeyFuncs<FInputAxisKeyMapping, FInputAxisKeyMapping>
+{
+	static const FInputAxisKeyMapping& GetSetKey(const FInputAxisKeyMapping& element) { return element; }
+	static bool Matches(const FInputAxisKeyMapping& a, const FInputAxisKeyMapping& b) { return a == b; }
+	//scale is left out, as 0 and -0 compare equal but hash differently
+	static uint32 GetKeyHash(const FInputAxisKeyMapping& mapping) { return HashCombine(GetTypeHash(mapping.AxisName), GetTypeHash(mapping.Key)); }
+};
+
+/**
+ * Reverse index from key to the actions and axes bound to it, mirroring the UInputSettings
+ * mapping arrays. UInputConfig keeps it current as it edits mappings, so conflict checks only
+ * look at the handful of bindings on one key instead of every mapping.
+ *
+ * It also groups the mappings by action and axis name, already converted to FActionMap and
+ * FAxisMap, so the UInputConfig queries can hand out references instead of building arrays.
+ */
+class FInputBindingIndex
+{
+public:
+
+	enum EModifier
+	{
+		Shift	= 1 << 0,
+		Ctrl	= 1 << 1,
+		Alt		= 1 << 2,
+		Cmd		= 1 << 3,
+	};
+
+	static uint8 MakeModifiers(bool ctrl, bool shift, bool alt, bool cmd);
+	static uint8 MakeModifiers(const FInputActionKeyMapping& mapping);
+
+	/** The index for the UInputSettings CDO, rebuilt if the mapping arrays were changed behind its back. */
+	static FInputBindingIndex& Get(const UInputSettings* settings);
+
+	/**
+	 * Call after changing the CDO mapping arrays without the edit functions below, e.g. after a
+	 * ReloadConfig. Bumps the settings generation, so the index rebuilds on its next Get.
+	 */
+	static void MarkSettingsChanged();
+
+	FInputBindingIndex();
+
+	void Build(const TArray<FInputActionKeyMapping>& actions, const TArray<FInputAxisKeyMapping>& axes);
+	void Invalidate();
+
+	//Mirror UInputSettings: adds are unique, removes take every equal mapping
+	void AddAction(const FInputActionKeyMapping& mapping);
+	void RemoveAction(const FInputActionKeyMapping& mapping);
+	void ModifyAction(FName actionName, const FKey& key, uint8 oldModifiers, uint8 newModifiers);
+	void AddAxis(const FInputAxisKeyMapping& mapping);
+	void RemoveAxis(const FInputAxisKeyMapping& mapping);
+	void ModifyAxis(FName axisName, const FKey& key, float oldScale, float newScale);
+
+	/** True if anything other than requestedBind uses the key, with any modifiers. */
+	bool IsBoundToOther(const FKey& key, FName requestedBind) const;
+
+	/**
+	 * Actions and axes that would fire together with key + modifiers. Actions conflict when either
+	 * chord's modifiers are a subset of the other's; axes ignore modifiers and always conflict.
+	 */
+	void GetConflicts(const FKey& key, uint8 modifiers, TArray<FName>& outNames) const;
+
+	//Grouped views, in the order the names and mappings appear in the settings.
+	//Valid until the next edit; unknown names give an empty array.
+	const TArray<FName>& GetActionNames() const { return ActionNames; }
+	const TArray<FName>& GetAxisNames() const { return AxisNames; }
+	const TArray<FActionMap>& GetActionMaps(FName actionName) const;
+	const TArray<FAxisMap>& GetAxisMaps(FName axisName) const;
+
+private:
+
+	void AddActionMap(const FInputActionKeyMapping& mapping);
+	void AddAxisMap(const FInputAxisKeyMapping& mapping);
+
+	bool IsCurrent(const UInputSettings* settings) const;
+
+	TMap<FKey, TArray<FKeyBinding>> BindingsByKey;
+
+	TArray<FName> ActionNames;
+	TArray<FName> AxisNames;
+	TMap<FName, TArray<FActionMap>> ActionsByName;
+	TMap<FName, TArray<FAxisMap>> AxesByName;
+
+	//bumped by MarkSettingsChanged; the index is current while it matches BuiltGeneration
+	static int32 SettingsGeneration;
+	int32 BuiltGeneration;
+
+	int32 NumActions;
+	int32 NumAxes;
+	bool bBuilt;
+};
@@ -2,10 +2,55 @@
 
 #include "ExtraConfigPrivatePCH.h"
 #include "InputConfig.h"
+#include "ConfigBackend.h"
+#include "ConfigNotifications.h"
+#include "ConfigSnapshot.h"
+#include "InputBindingIndex.h"
+#include "InputProfileStore.h"
+#include "AnalogConfigIndex.h"
+#include "ConfigLatentAction.h"
 #include "Runtime/Engine/Classes/GameFramework/PlayerInput.h"
 #include "Runtime/Engine/Classes/GameFramework/InputSettings.h"
 #include "Runtime/CoreUObject/Public/UObject/UObjectGlobals.h"
 
+DECLARE_CYCLE_STAT(TEXT("UInputConfig::AddActionMapping"), STAT_ExtraConfig_AddActionMapping, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UInputConfig::RemoveActionMapping"), STAT_ExtraConfig_RemoveActionMapping, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UInputConfig::ModifyActionMapping"), STAT_ExtraConfig_ModifyActionMapping, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UInputConfig::GetActionNames"), STAT_ExtraConfig_GetActionNames, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UInputConfig::GetKeysForAction"), STAT_ExtraConfig_GetKeysForAction, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UInputConfig::ViewActionNames"), STAT_ExtraConfig_ViewActionNames, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UInputConfig::ViewKeysForAction"), STAT_ExtraConfig_ViewKeysForAction, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UInputConfig::AddAxisMapping"), STAT_ExtraConfig_AddAxisMapping, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UInputConfig::RemoveAxisMapping"), STAT_ExtraConfig_RemoveAxisMapping, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UInputConfig::ModifyAxisMapping"), STAT_ExtraConfig_ModifyAxisMapping, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UInputConfig::GetAxisNames"), STAT_ExtraConfig_GetAxisNames, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UInputConfig::GetKeysForAxis"), STAT_ExtraConfig_GetKeysForAxis, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UInputConfig::ViewAxisNames"), STAT_ExtraConfig_ViewAxisNames, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UInputConfig::ViewKeysForAxis"), STAT_ExtraConfig_ViewKeysForAxis, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UInputConfig::AddAnalogConfig"), STAT_ExtraConfig_AddAnalogConfig, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UInputConfig::RemoveAnalogConfig"), STAT_ExtraConfig_RemoveAnalogConfig, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UInputConfig::ModifyAnalogConfig"), STAT_ExtraConfig_ModifyAnalogConfig, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UInputConfig::GetAnalogKeys"), STAT_ExtraConfig_GetAnalogKeys, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UInputConfig::ViewAnalogKeys"), STAT_ExtraConfig_ViewAnalogKeys, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UInputConfig::GetConfigForAnalog"), STAT_ExtraConfig_GetConfigForAnalog, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UInputConfig::EvaluateAnalog"), STAT_ExtraConfig_EvaluateAnalog, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UInputConfig::EvaluateAnalogBatch"), STAT_ExtraConfig_EvaluateAnalogBatch, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UInputConfig::SaveChanges"), STAT_ExtraConfig_SaveChanges, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UInputConfig::RequestSaveChanges"), STAT_ExtraConfig_RequestSaveChanges, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UInputConfig::DiscardChanges"), STAT_ExtraConfig_DiscardChanges, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UInputConfig::IsDoubleBound"), STAT_ExtraConfig_IsDoubleBound, STATGROUP_ExtraConfig);
+DECLARE_CYCLE_STAT(TEXT("UInputConfig::GetConflicts"), STAT_ExtraConfig_GetConflicts, STATGROUP_ExtraConfig);
+
+DECLARE_CYCLE_STAT(TEXT("SaveChanges Rebuild"), STAT_ExtraConfig_SaveChangesRebuild, STATGROUP_ExtraConfig);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("SaveChanges PlayerInputs Touched"), STAT_ExtraConfig_PlayerInputsTouched, STATGROUP_ExtraConfig);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("SaveChanges Names Rebuilt"), STAT_ExtraConfig_NamesRebuilt, STATGROUP_ExtraConfig);
+
+//Action and axis names edited since the last SaveChanges; only these are pushed to the players
+static TSet<FName> DirtyActionNames;
+static TSet<FName> DirtyAxisNames;
+//Analog keys whose AxisConfig entry was added, edited or removed since the last SaveChanges
+static TSet<FName> DirtyAnalogKeys;
+
 UInputConfig::UInputConfig(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
 {
 
@@ -17,42 +62,62 @@ UInputConfig::UInputConfig(const FObjectInitializer& ObjectInitializer) : Super(
 
 bool UInputConfig::AddActionMapping(FName actionName, FKey newKey, bool ctrl, bool shift, bool alt, bool cmd)
 {
-	UInputSettings* Settings = UInputSettings::StaticClass()->GetDefaultObject<UInputSettings>();
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_AddActionMapping);
+
+	UInputSettings* Settings = IConfigBackend::Get().GetInputSettings();
 	if (!Settings) return false;
 
 	FInputActionKeyMapping newAction(actionName, newKey, shift, ctrl, alt, cmd);
 
-	Settings->AddActionMapping(newAction);
+	FInputBindingIndex& index = FInputBindingIndex::Get(Settings);
+
+	//UInputSettings::AddActionMapping would rebuild every UPlayerInput; players pick this up in SaveChanges
+	Settings->ActionMappings.AddUnique(newAction);
+	index.AddAction(newAction);
+	DirtyActionNames.Add(actionName);
 
 	return true;
 }
 
 bool UInputConfig::RemoveActionMapping(FName actionName, FKey oldKey, bool ctrl, bool shift, bool alt, bool cmd)
 {
-	UInputSettings* Settings = UInputSettings::StaticClass()->GetDefaultObject<UInputSettings>();
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_RemoveActionMapping);
+
+	UInputSettings* Settings = IConfigBackend::Get().GetInputSettings();
 	if (!Settings) return false;
 
 	FInputActionKeyMapping oldAction(actionName, oldKey, shift, ctrl, alt, cmd);
 
-	Settings->RemoveActionMapping(oldAction);
+	FInputBindingIndex& index = FInputBindingIndex::Get(Settings);
+
+	Settings->ActionMappings.Remove(oldAction);
+	index.RemoveAction(oldAction);
+	DirtyActionNames.Add(actionName);
 
 	return true;
 }
 
 bool UInputConfig::ModifyActionMapping(FName actionName, FKey key, bool ctrl, bool shift, bool alt, bool cmd)
 {
-	UInputSettings* Settings = UInputSettings::StaticClass()->GetDefaultObject<UInputSettings>();
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_ModifyActionMapping);
+
+	UInputSettings* Settings = IConfigBackend::Get().GetInputSettings();
 	if (!Settings) return false;
 
 	for (auto& actionMap : Settings->ActionMappings)
 	{
 		if (actionMap.ActionName == actionName && actionMap.Key == key)
 		{
+			FInputBindingIndex::Get(Settings).ModifyAction(actionName, key,
+				FInputBindingIndex::MakeModifiers(actionMap), FInputBindingIndex::MakeModifiers(ctrl, shift, alt, cmd));
+
 			actionMap.bCtrl = ctrl;
 			actionMap.bShift = shift;
 			actionMap.bAlt = alt;
 			actionMap.bCmd = cmd;
 
+			DirtyActionNames.Add(actionName);
+
 			return true;
 		}
 	}
@@ -62,31 +127,40 @@ bool UInputConfig::ModifyActionMapping(FName actionName, FKey key, bool ctrl, bo
 
 TArray<FName> UInputConfig::GetActionNames()
 {
-	TArray<FName> tempActions;
-	UInputSettings* Settings = UInputSettings::StaticClass()->GetDefaultObject<UInputSettings>();
-	if (Settings)
-	{
-		Settings->GetActionNames(tempActions);
-	}
-	return tempActions;
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_GetActionNames);
+
+	return ViewActionNames();
 }
 
 TArray<FActionMap> UInputConfig::GetKeysForAction(FName actionName)
 {
-	TArray<FActionMap> maps;
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_GetKeysForAction);
+
+	return ViewKeysForAction(actionName);
+}
+
+const TArray<FName>& UInputConfig::ViewActionNames()
+{
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_ViewActionNames);
 
-	UInputSettings* Settings = UInputSettings::StaticClass()->GetDefaultObject<UInputSettings>();
-	if (!Settings) return TArray<FActionMap>();
+	static const TArray<FName> None;
 
-	for (auto actionMap : Settings->ActionMappings)
-	{
-		if (actionMap.ActionName == actionName)
-		{
-			maps.Add(FActionMap(actionMap.ActionName, actionMap.Key, actionMap.bShift, actionMap.bCtrl, actionMap.bAlt, actionMap.bCmd));
-		}
-	}
+	UInputSettings* Settings = IConfigBackend::Get().GetInputSettings();
+	if (!Settings) return None;
+
+	return FInputBindingIndex::Get(Settings).GetActionNames();
+}
+
+const TArray<FActionMap>& UInputConfig::ViewKeysForAction(FName actionName)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_ViewKeysForAction);
+
+	static const TArray<FActionMap> None;
 
-	return maps;
+	UInputSettings* Settings = IConfigBackend::Get().GetInputSettings();
+	if (!Settings) return None;
+
+	return FInputBindingIndex::Get(Settings).GetActionMaps(actionName);
 }
 
 // ----
@@ -95,40 +169,55 @@ TArray<FActionMap> UInputConfig::GetKeysForAction(FName actionName)
 
 bool UInputConfig::AddAxisMapping(FName axisName, FKey newKey, float scale)
 {
-	UInputSettings* Settings = UInputSettings::StaticClass()->GetDefaultObject<UInputSettings>();
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_AddAxisMapping);
+
+	UInputSettings* Settings = IConfigBackend::Get().GetInputSettings();
 	if (!Settings) return false;
 
 	FInputAxisKeyMapping newAxis(axisName, newKey, scale);
 
-	Settings->AddAxisMapping(newAxis);
+	FInputBindingIndex& index = FInputBindingIndex::Get(Settings);
+
+	Settings->AxisMappings.AddUnique(newAxis);
+	index.AddAxis(newAxis);
+	DirtyAxisNames.Add(axisName);
 
 	return true;
 }
 
 bool UInputConfig::RemoveAxisMapping(FName axisName, FKey oldKey, float scale)
 {
-	UInputSettings* Settings = UInputSettings::StaticClass()->GetDefaultObject<UInputSettings>();
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_RemoveAxisMapping);
+
+	UInputSettings* Settings = IConfigBackend::Get().GetInputSettings();
 	if (!Settings) return false;
 
 	FInputAxisKeyMapping oldAxis(axisName, oldKey, scale);
 
-	TArray<FInputAxisKeyMapping> tempMaps(Settings->AxisMappings);
-	
-	Settings->RemoveAxisMapping(oldAxis);
+	FInputBindingIndex& index = FInputBindingIndex::Get(Settings);
+
+	Settings->AxisMappings.Remove(oldAxis);
+	index.RemoveAxis(oldAxis);
+	DirtyAxisNames.Add(axisName);
 
 	return true;
 }
 
 bool UInputConfig::ModifyAxisMapping(FName axisName, FKey key, float scale)
 {
-	UInputSettings* Settings = UInputSettings::StaticClass()->GetDefaultObject<UInputSettings>();
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_ModifyAxisMapping);
+
+	UInputSettings* Settings = IConfigBackend::Get().GetInputSettings();
 	if (!Settings) return false;
 
 	for (auto& axisMap : Settings->AxisMappings)
 	{
 		if (axisMap.AxisName == axisName && axisMap.Key == key)
 		{
+			FInputBindingIndex::Get(Settings).ModifyAxis(axisName, key, axisMap.Scale, scale);
+
 			axisMap.Scale = scale;
+			DirtyAxisNames.Add(axisName);
 			return true;
 		}
 	}
@@ -138,31 +227,40 @@ bool UInputConfig::ModifyAxisMapping(FName axisName, FKey key, float scale)
 
 TArray<FName> UInputConfig::GetAxisNames()
 {
-	TArray<FName> tempAxes;
-	UInputSettings* Settings = UInputSettings::StaticClass()->GetDefaultObject<UInputSettings>();
-	if (Settings)
-	{
-		Settings->GetAxisNames(tempAxes);
-	}
-	return tempAxes;
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_GetAxisNames);
+
+	return ViewAxisNames();
 }
 
 TArray<FAxisMap> UInputConfig::GetKeysForAxis(FName axisName)
 {
-	UInputSettings* Settings = UInputSettings::StaticClass()->GetDefaultObject<UInputSettings>();
-	if (!Settings) return TArray<FAxisMap>();
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_GetKeysForAxis);
 
-	TArray<FAxisMap> maps;
+	return ViewKeysForAxis(axisName);
+}
 
-	for (auto axisMap : Settings->AxisMappings)
-	{
-		if (axisMap.AxisName == axisName)
-		{
-			maps.Add(FAxisMap(axisMap.AxisName, axisMap.Key, axisMap.Scale));
-		}
-	}
+const TArray<FName>& UInputConfig::ViewAxisNames()
+{
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_ViewAxisNames);
+
+	static const TArray<FName> None;
+
+	UInputSettings* Settings = IConfigBackend::Get().GetInputSettings();
+	if (!Settings) return None;
+
+	return FInputBindingIndex::Get(Settings).GetAxisNames();
+}
+
+const TArray<FAxisMap>& UInputConfig::ViewKeysForAxis(FName axisName)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_ViewKeysForAxis);
+
+	static const TArray<FAxisMap> None;
+
+	UInputSettings* Settings = IConfigBackend::Get().GetInputSettings();
+	if (!Settings) return None;
 
-	return maps;
+	return FInputBindingIndex::Get(Settings).GetAxisMaps(axisName);
 }
 
 // ------
@@ -171,104 +269,130 @@ TArray<FAxisMap> UInputConfig::GetKeysForAxis(FName axisName)
 
 bool UInputConfig::AddAnalogConfig(FKey axisKey, bool invert, float deadZone, float sensitivity, float exponent)
 {
-	UInputSettings* Settings = UInputSettings::StaticClass()->GetDefaultObject<UInputSettings>();
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_AddAnalogConfig);
+
+	UInputSettings* Settings = IConfigBackend::Get().GetInputSettings();
 	if (!Settings) return false;
 
-	int32 idx = Settings->AxisConfig.Add(FInputAxisConfigEntry());
+	//updates the existing entry rather than adding a second one for the same key
+	FAnalogConfigIndex& index = FAnalogConfigIndex::Get(Settings);
+	int32 idx = index.FindOrAdd(Settings, axisKey.GetFName());
+	index.InvalidateCurve(axisKey.GetFName());
+
 	FInputAxisConfigEntry& entry = Settings->AxisConfig[idx];
 
-	entry.AxisKeyName = axisKey.GetFName();
 	entry.AxisProperties.bInvert = invert;
 	entry.AxisProperties.DeadZone = deadZone;
 	entry.AxisProperties.Exponent = exponent;
 	entry.AxisProperties.Sensitivity = sensitivity;
+	FAnalogResponseCurve::ClampProperties(entry.AxisProperties);
+
+	DirtyAnalogKeys.Add(axisKey.GetFName());
 
 	return true;
 }
 
 bool UInputConfig::RemoveAnalogConfig(FKey axisKey)
 {
-	UInputSettings* Settings = UInputSettings::StaticClass()->GetDefaultObject<UInputSettings>();
-	if (!Settings) return false;
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_RemoveAnalogConfig);
 
-	FName keyName = axisKey.GetFName();
+	UInputSettings* Settings = IConfigBackend::Get().GetInputSettings();
+	if (!Settings) return false;
 
-	//have to use index here, as FInputAxisConfigEntry does not have a == operator,
-	//rendering TArray<>::Remove useless.
-	for (int32 i = 0; i < Settings->AxisConfig.Num(); i++)
+	if (!FAnalogConfigIndex::Get(Settings).Remove(Settings, axisKey.GetFName()))
 	{
-		FInputAxisConfigEntry& config = Settings->AxisConfig[i];
-		if (keyName == (config.AxisKeyName))
-		{
-			Settings->AxisConfig.RemoveAtSwap(i);
-
-			return true;
-		}
+		return false;
 	}
 
-	return false;
+	DirtyAnalogKeys.Add(axisKey.GetFName());
+
+	return true;
 }
 
 bool UInputConfig::ModifyAnalogConfig(FKey axisKey, bool invert, float deadZone, float sensitivity, float exponent)
 {
-	UInputSettings* Settings = UInputSettings::StaticClass()->GetDefaultObject<UInputSettings>();
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_ModifyAnalogConfig);
+
+	UInputSettings* Settings = IConfigBackend::Get().GetInputSettings();
 	if (!Settings) return false;
 
-	FName keyName = axisKey.GetFName();
+	FAnalogConfigIndex& index = FAnalogConfigIndex::Get(Settings);
+	int32 idx = index.Find(axisKey.GetFName());
+	if (idx == INDEX_NONE) return false;
 
-	for (auto& config : Settings->AxisConfig)
-	{
-		if (keyName == (config.AxisKeyName))
-		{
-			config.AxisProperties.bInvert = invert;
-			config.AxisProperties.DeadZone = deadZone;
-			config.AxisProperties.Exponent = exponent;
-			config.AxisProperties.Sensitivity = sensitivity;
-			return true;
-		}
-	}
+	index.InvalidateCurve(axisKey.GetFName());
 
-	return false;
+	FInputAxisConfigEntry& config = Settings->AxisConfig[idx];
+	config.AxisProperties.bInvert = invert;
+	config.AxisProperties.DeadZone = deadZone;
+	config.AxisProperties.Exponent = exponent;
+	config.AxisProperties.Sensitivity = sensitivity;
+	FAnalogResponseCurve::ClampProperties(config.AxisProperties);
+
+	DirtyAnalogKeys.Add(axisKey.GetFName());
+
+	return true;
 }
 
 TArray<FKey> UInputConfig::GetAnalogKeys()
 {
-	UInputSettings* Settings = UInputSettings::StaticClass()->GetDefaultObject<UInputSettings>();
-	if (!Settings) return TArray<FKey>();
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_GetAnalogKeys);
 
-	TArray<FKey> keys;
+	return ViewAnalogKeys();
+}
 
-	for (auto config : Settings->AxisConfig)
-	{
-		FKey key(config.AxisKeyName);
-		if (!(keys.Contains(key)))
-		{
-			keys.Add(key);
-		}
-	}
+const TArray<FKey>& UInputConfig::ViewAnalogKeys()
+{
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_ViewAnalogKeys);
+
+	static const TArray<FKey> None;
 
-	return keys;
+	UInputSettings* Settings = IConfigBackend::Get().GetInputSettings();
+	if (!Settings) return None;
+
+	return FAnalogConfigIndex::Get(Settings).GetKeys();
 }
 
 FAnalogConfig UInputConfig::GetConfigForAnalog(FKey key)
 {
-	UInputSettings* Settings = UInputSettings::StaticClass()->GetDefaultObject<UInputSettings>();
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_GetConfigForAnalog);
+
+	UInputSettings* Settings = IConfigBackend::Get().GetInputSettings();
 	if (!Settings) return FAnalogConfig();
 
-	for (auto config : Settings->AxisConfig)
+	int32 idx = FAnalogConfigIndex::Get(Settings).Find(key.GetFName());
+	if (idx == INDEX_NONE) return FAnalogConfig();
+
+	const FInputAxisProperties& properties = Settings->AxisConfig[idx].AxisProperties;
+
+	return FAnalogConfig(key, properties.bInvert, properties.DeadZone, properties.Exponent, properties.Sensitivity);
+}
+
+float UInputConfig::EvaluateAnalog(FKey key, float value)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_EvaluateAnalog);
+
+	UInputSettings* Settings = IConfigBackend::Get().GetInputSettings();
+	if (!Settings) return value;
+
+	return FAnalogConfigIndex::Get(Settings).GetCurve(Settings, key.GetFName()).Evaluate(value);
+}
+
+void UInputConfig::EvaluateAnalogBatch(FKey key, const float* in, float* out, int32 count)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_EvaluateAnalogBatch);
+
+	UInputSettings* Settings = IConfigBackend::Get().GetInputSettings();
+	if (!Settings)
 	{
-		if ((config.AxisKeyName) == key.GetFName())
+		if (in != out)
 		{
-			bool invert = config.AxisProperties.bInvert;
-			float dz = config.AxisProperties.DeadZone;
-			float exp = config.AxisProperties.Exponent;
-			float mult = config.AxisProperties.Sensitivity;
-
-			return FAnalogConfig(key, invert, dz, exp, mult);
+			FMemory::Memcpy(out, in, count * sizeof(float));
 		}
+		return;
 	}
 
-	return FAnalogConfig();
+	FAnalogConfigIndex::Get(Settings).GetCurve(Settings, key.GetFName()).EvaluateBatch(in, out, count);
 }
 
 // -------
@@ -277,42 +401,288 @@ FAnalogConfig UInputConfig::GetConfigForAnalog(FKey key)
 
 void UInputConfig::SaveChanges()
 {
-	UInputSettings* Settings = UInputSettings::StaticClass()->GetDefaultObject<UInputSettings>();
-	Settings->SaveConfig();
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_SaveChanges);
+
+	IConfigBackend& backend = IConfigBackend::Get();
+	UInputSettings* Settings = backend.GetInputSettings();
+	backend.SaveInputSettings();
+
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_SaveChangesRebuild);
+
+	if (DirtyActionNames.Num() == 0 && DirtyAxisNames.Num() == 0 && DirtyAnalogKeys.Num() == 0)
+	{
+		return;
+	}
+
+	//listeners hear about input edits once they are committed, together with the players
+	int32 changed = (DirtyActionNames.Num() > 0 ? 1 << (int32)EConfigChange::ActionMappings : 0)
+		| (DirtyAxisNames.Num() > 0 ? 1 << (int32)EConfigChange::AxisMappings : 0)
+		| (DirtyAnalogKeys.Num() > 0 ? 1 << (int32)EConfigChange::AnalogConfig : 0);
+
+	//the current mappings for every edited name, gathered once for all players
+	TArray<FInputActionKeyMapping> changedActions;
+	for (const FInputActionKeyMapping& mapping : Settings->ActionMappings)
+	{
+		if (DirtyActionNames.Contains(mapping.ActionName))
+		{
+			changedActions.Add(mapping);
+		}
+	}
+
+	TArray<FInputAxisKeyMapping> changedAxes;
+	for (const FInputAxisKeyMapping& mapping : Settings->AxisMappings)
+	{
+		if (DirtyAxisNames.Contains(mapping.AxisName))
+		{
+			changedAxes.Add(mapping);
+		}
+	}
+
+	//removed keys have no entry left, so players just drop theirs
+	TArray<FInputAxisConfigEntry> changedAnalog;
+	for (const FInputAxisConfigEntry& entry : Settings->AxisConfig)
+	{
+		if (DirtyAnalogKeys.Contains(entry.AxisKeyName))
+		{
+			changedAnalog.Add(entry);
+		}
+	}
 
-	//REBUILDS INPUT, creates modified config in Saved/Config/Windows/Input.ini
-	for (TObjectIterator<UPlayerInput> It; It; ++It)
+	int32 touched = 0;
+
+	TArray<ULocalPlayer*> players;
+	backend.GetLocalPlayers(players);
+
+	for (ULocalPlayer* player : players)
 	{
-		It->ForceRebuildingKeyMaps(true);
+		UPlayerInput* playerInput = (player && player->PlayerController) ? player->PlayerController->PlayerInput : nullptr;
+		if (!playerInput)
+		{
+			continue;
+		}
+
+		//players with their own profile keep its mappings; profiles don't hold analog config
+		if (!FInputProfileStore::Get().HasCustomProfile(player))
+		{
+			playerInput->ActionMappings.RemoveAll([](const FInputActionKeyMapping& mapping) { return DirtyActionNames.Contains(mapping.ActionName); });
+			playerInput->ActionMappings.Append(changedActions);
+
+			playerInput->AxisMappings.RemoveAll([](const FInputAxisKeyMapping& mapping) { return DirtyAxisNames.Contains(mapping.AxisName); });
+			playerInput->AxisMappings.Append(changedAxes);
+		}
+		else if (DirtyAnalogKeys.Num() == 0)
+		{
+			continue;
+		}
+
+		playerInput->AxisConfig.RemoveAll([](const FInputAxisConfigEntry& entry) { return DirtyAnalogKeys.Contains(entry.AxisKeyName); });
+		playerInput->AxisConfig.Append(changedAnalog);
+
+		INC_DWORD_STAT(STAT_ExtraConfig_KeyMapRebuilds);
+
+		//false keeps the player's own mappings instead of copying every default back in;
+		//it also drops the AxisProperties cache, which is rebuilt from the AxisConfig above
+		playerInput->ForceRebuildingKeyMaps(false);
+		touched++;
 	}
+
+	FInputProfileStore::Get().RefreshDefaults();
+
+	SET_DWORD_STAT(STAT_ExtraConfig_PlayerInputsTouched, touched);
+	SET_DWORD_STAT(STAT_ExtraConfig_NamesRebuilt, DirtyActionNames.Num() + DirtyAxisNames.Num() + DirtyAnalogKeys.Num());
+
+	DirtyActionNames.Empty();
+	DirtyAxisNames.Empty();
+	DirtyAnalogKeys.Empty();
+
+	FConfigSnapshot::PublishCurrent();
+	UConfigNotifications::MarkChanged(changed, 0);
+}
+
+void UInputConfig::SaveChangesAsync(UObject* worldContextObject, FLatentActionInfo latentInfo)
+{
+	TConfigLatentAction<bool>::Start(worldContextObject, latentInfo, nullptr, [](TFunction<void(const bool&)> onComplete)
+	{
+		RequestSaveChanges([onComplete]() { onComplete(true); });
+	});
+}
+
+void UInputConfig::RequestSaveChanges(TFunction<void()> onComplete)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_RequestSaveChanges);
+
+	//the players are updated here; the ini write is already queued to the persistence worker
+	SaveChanges();
+
+	IConfigBackend::Get().WhenWritten(onComplete);
 }
 
 void UInputConfig::DiscardChanges()
 {
-	UInputSettings* Settings = UInputSettings::StaticClass()->GetDefaultObject<UInputSettings>();
-	Settings->ReloadConfig();
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_DiscardChanges);
+
+	IConfigBackend& backend = IConfigBackend::Get();
+	UInputSettings* Settings = backend.GetInputSettings();
+	backend.ReloadInputSettings();
+
+	FInputBindingIndex::MarkSettingsChanged();
+	FAnalogConfigIndex::MarkSettingsChanged();
+	FAnalogConfigIndex::CompactSettings(Settings);
+
+	//edits never reached the players or the listeners, so there is nothing left to push
+	DirtyActionNames.Empty();
+	DirtyAxisNames.Empty();
+	DirtyAnalogKeys.Empty();
 }
 
 bool UInputConfig::IsDoubleBound(FKey key, FName requestedBind)
 {
-	UInputSettings* Settings = UInputSettings::StaticClass()->GetDefaultObject<UInputSettings>();
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_IsDoubleBound);
+
+	UInputSettings* Settings = IConfigBackend::Get().GetInputSettings();
 	if (!Settings) return false;
 
-	for (auto action : Settings->ActionMappings)
+	return FInputBindingIndex::Get(Settings).IsBoundToOther(key, requestedBind);
+}
+
+TArray<FName> UInputConfig::GetConflicts(FKey key, bool ctrl, bool shift, bool alt, bool cmd)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ExtraConfig_GetConflicts);
+
+	TArray<FName> names;
+
+	UInputSettings* Settings = IConfigBackend::Get().GetInputSettings();
+	if (!Settings) return names;
+
+	FInputBindingIndex::Get(Settings).GetConflicts(key, FInputBindingIndex::MakeModifiers(ctrl, shift, alt, cmd), names);
+
+	return names;
+}
+
+// ---------
+// Benchmark
+// ---------
+
+static void BenchBindings(const TArray<FString>& args)
+{
+	int32 mappingCount = args.Num() > 0 ? FCString::Atoi(*args[0]) : 10000;
+	mappingCount = FMath::Max(mappingCount, 1);
+
+	const int32 keyCount = 200;
+	TArray<FKey> keys;
+	for (int32 i = 0; i < keyCount; i++)
+	{
+		keys.Add(FKey(FName(*FString::Printf(TEXT("BenchKey%d"), i))));
+	}
+
+	TArray<FInputActionKeyMapping> actions;
+	TArray<FInputAxisKeyMapping> axes;
+	for (int32 i = 0; i < mappingCount; i++)
 	{
-		if (action.ActionName != requestedBind && action.Key == key)
+		FName name(*FString::Printf(TEXT("BenchBinding%d"), i));
+		if (i % 4 == 0)
 		{
-			return true;
+			axes.Add(FInputAxisKeyMapping(name, keys[i % keyCount], 1.f));
+		}
+		else
+		{
+			actions.Add(FInputActionKeyMapping(name, keys[i % keyCount], (i & 1) != 0));
 		}
 	}
 
-	for (auto axis : Settings->AxisMappings)
+	FName requested(TEXT("BenchBinding0"));
+	int32 hits = 0;
+
+	//what IsDoubleBound used to do for every key row
+	double start = FPlatformTime::Seconds();
+	for (const FKey& key : keys)
 	{
-		if (axis.AxisName != requestedBind && axis.Key == key)
+		bool bBound = false;
+		for (const FInputActionKeyMapping& action : actions)
 		{
-			return true;
+			if (action.ActionName != requested && action.Key == key)
+			{
+				bBound = true;
+				break;
+			}
 		}
+		for (int32 i = 0; !bBound && i < axes.Num(); i++)
+		{
+			bBound = axes[i].AxisName != requested && axes[i].Key == key;
+		}
+		hits += bBound ? 1 : 0;
 	}
+	double scan = FPlatformTime::Seconds() - start;
 
-	return false;
+	start = FPlatformTime::Seconds();
+	FInputBindingIndex index;
+	index.Build(actions, axes);
+	double build = FPlatformTime::Seconds() - start;
+
+	start = FPlatformTime::Seconds();
+	for (const FKey& key : keys)
+	{
+		hits += index.IsBoundToOther(key, requested) ? 1 : 0;
+	}
+	double indexed = FPlatformTime::Seconds() - start;
+
+	UE_LOG(LogExtraConfig, Display, TEXT("IsDoubleBound over %d keys, %d mappings: scan %.3f ms, index %.3f ms (build %.3f ms) [%d]"),
+		keyCount, mappingCount, scan * 1000.0, indexed * 1000.0, build * 1000.0, hits);
 }
+
+static FAutoConsoleCommand BenchBindingsCommand(
+	TEXT("ExtraConfig.BenchBindings"),
+	TEXT("Times conflict checks with a linear scan and with the key index. Optional argument: mapping count."),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&BenchBindings));
+
+static void BenchAnalogCurves(const TArray<FString>& args)
+{
+	int32 sampleCount = args.Num() > 0 ? FCString::Atoi(*args[0]) : 1000000;
+	sampleCount = FMath::Max(sampleCount, 4);
+
+	FInputAxisProperties properties;
+	properties.DeadZone = 0.2f;
+	properties.Exponent = 2.5f;
+	properties.Sensitivity = 1.5f;
+	properties.bInvert = true;
+
+	FAnalogResponseCurve curve(properties);
+
+	//a sweep over the full stick range
+	TArray<float> input;
+	input.SetNumUninitialized(sampleCount);
+	for (int32 i = 0; i < sampleCount; i++)
+	{
+		input[i] = -1.f + 2.f * i / (sampleCount - 1);
+	}
+
+	TArray<float> exact;
+	exact.SetNumUninitialized(sampleCount);
+	TArray<float> batched;
+	batched.SetNumUninitialized(sampleCount);
+
+	double start = FPlatformTime::Seconds();
+	for (int32 i = 0; i < sampleCount; i++)
+	{
+		exact[i] = FAnalogResponseCurve::EvaluateExact(properties, input[i]);
+	}
+	double scalar = FPlatformTime::Seconds() - start;
+
+	start = FPlatformTime::Seconds();
+	curve.EvaluateBatch(input.GetData(), batched.GetData(), sampleCount);
+	double batch = FPlatformTime::Seconds() - start;
+
+	float maxError = 0.f;
+	for (int32 i = 0; i < sampleCount; i++)
+	{
+		maxError = FMath::Max(maxError, FMath::Abs(exact[i] - batched[i]));
+	}
+
+	UE_LOG(LogExtraConfig, Display, TEXT("Analog curve over %d samples: exact %.1f Msamples/s, batch %.1f Msamples/s, max error %g"),
+		sampleCount, sampleCount / FMath::Max(scalar, 1e-9) / 1e6, sampleCount / FMath::Max(batch, 1e-9) / 1e6, maxError);
+}
+
+static FAutoConsoleCommand BenchAnalogCurvesCommand(
+	TEXT("ExtraConfig.BenchAnalogCurves"),
+	TEXT("Compares the exact analog response formula with the batched lookup table. Optional argument: sample count."),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&BenchAnalogCurves));
@@ -0,0 +1,67 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "GameFramework/PlayerInput.h"
+
+struct FInputBindingSet
+{
+	TArray<FInputActionKeyMapping> ActionMappings;
+	TArray<FInputAxisKeyMapping> AxisMappings;
+};
+
+/**
+ * Bindings for one local player. Every profile starts out pointing at the shared default set and
+ * only gets its own copy the first time it is edited, so players on the defaults cost nothing.
+ */
+class FInputProfile
+{
+public:
+
+	explicit FInputProfile(const TSharedRef<FInputBindingSet>& defaults) : Bindings(defaults) {}
+
+	const FInputBindingSet& Get() const { return *Bindings; }
+
+	/** Copies the shared set on first write. */
+	FInputBindingSet& Edit();
+
+	bool SharesWith(const TSharedRef<FInputBindingSet>& set) const { return Bindings == set; }
+
+	void Reset(const TSharedRef<FInputBindingSet>& defaults) { Bindings = defaults; }
+
+private:
+
+	TSharedRef<FInputBindingSet> Bindings;
+};
+
+/** Per-player profiles, keyed by local player. */
+class FInputProfileStore
+{
+public:
+
+	static FInputProfileStore& Get();
+
+	/** The profile for the player, created on the defaults if it doesn't exist yet. */
+	FInputProfile& FindOrAdd(ULocalPlayer* player);
+
+	/** True if the player has edited their own bindings, in which case global edits no longer reach them. */
+	bool HasCustomProfile(ULocalPlayer* player) const;
+
+	void Reset(ULocalPlayer* player);
+
+	/** Re-snapshots the UInputSettings mappings after a save; players still on the defaults follow along. */
+	void RefreshDefaults();
+
+	/** Copies the profile's bindings into the player's UPlayerInput and rebuilds its key maps. */
+	static void ApplyToPlayer(ULocalPlayer* player, const FInputBindingSet& bindings);
+
+private:
+
+	FInputProfileStore();
+
+	TSharedRef<FInputBindingSet> GetDefaults();
+	void RemoveStalePlayers();
+
+	TSharedPtr<FInputBindingSet> Defaults;
+	TMap<TWeakObjectPtr<ULocalPlayer>, FInputProfile> Profiles;
+};
@@ -0,0 +1,371 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ExtraConfigPrivatePCH.h"
+#include "InputProfiles.h"
+#include "InputProfileStore.h"
+#include "InputBindingIndex.h"
+#include "ConfigBackend.h"
+#include "GameFramework/InputSettings.h"
+
+// -----
+// Store
+// -----
+
+FInputBindingSet& FInputProfile::Edit()
+{
+	if (!Bindings.IsUnique())
+	{
+		Bindings = MakeShareable(new FInputBindingSet(*Bindings));
+	}
+
+	return *Bindings;
+}
+
+FInputProfileStore::FInputProfileStore()
+{
+}
+
+FInputProfileStore& FInputProfileStore::Get()
+{
+	static FInputProfileStore Instance;
+	return Instance;
+}
+
+TSharedRef<FInputBindingSet> FInputProfileStore::GetDefaults()
+{
+	if (!Defaults.IsValid())
+	{
+		const UInputSettings* Settings = IConfigBackend::Get().GetInputSettings();
+
+		Defaults = MakeShareable(new FInputBindingSet());
+		Defaults->ActionMappings = Settings->ActionMappings;
+		Defaults->AxisMappings = Settings->AxisMappings;
+	}
+
+	return Defaults.ToSharedRef();
+}
+
+void FInputProfileStore::RemoveStalePlayers()
+{
+	for (auto It = Profiles.CreateIterator(); It; ++It)
+	{
+		if (!It.Key().IsValid())
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+FInputProfile& FInputProfileStore::FindOrAdd(ULocalPlayer* player)
+{
+	FInputProfile* profile = Profiles.Find(player);
+	if (profile)
+	{
+		return *profile;
+	}
+
+	RemoveStalePlayers();
+
+	return Profiles.Add(player, FInputProfile(GetDefaults()));
+}
+
+bool FInputProfileStore::HasCustomProfile(ULocalPlayer* player) const
+{
+	const FInputProfile* profile = Profiles.Find(player);
+
+	return profile && Defaults.IsValid() && !profile->SharesWith(Defaults.ToSharedRef());
+}
+
+void FInputProfileStore::Reset(ULocalPlayer* player)
+{
+	FInputProfile* profile = Profiles.Find(player);
+	if (profile)
+	{
+		profile->Reset(GetDefaults());
+	}
+}
+
+void FInputProfileStore::RefreshDefaults()
+{
+	if (!Defaults.IsValid())
+	{
+		return;
+	}
+
+	TSharedRef<FInputBindingSet> oldDefaults = Defaults.ToSharedRef();
+	Defaults.Reset();
+	TSharedRef<FInputBindingSet> newDefaults = GetDefaults();
+
+	for (auto& entry : Profiles)
+	{
+		if (entry.Value.SharesWith(oldDefaults))
+		{
+			entry.Value.Reset(newDefaults);
+		}
+	}
+}
+
+void FInputProfileStore::ApplyToPlayer(ULocalPlayer* player, const FInputBindingSet& bindings)
+{
+	UPlayerInput* playerInput = (player && player->PlayerController) ? player->PlayerController->PlayerInput : nullptr;
+	if (!playerInput)
+	{
+		return;
+	}
+
+	playerInput->ActionMappings = bindings.ActionMappings;
+	playerInput->AxisMappings = bindings.AxisMappings;
+	INC_DWORD_STAT(STAT_ExtraConfig_KeyMapRebuilds);
+	playerInput->ForceRebuildingKeyMaps(false);
+}
+
+// -------
+// Helpers
+// -------
+
+static ULocalPlayer* GetLocalPlayer(APlayerController* player)
+{
+	return player ? player->GetLocalPlayer() : nullptr;
+}
+
+static UPlayerInput* GetPlayerInput(ULocalPlayer* localPlayer)
+{
+	return (localPlayer && localPlayer->PlayerController) ? localPlayer->PlayerController->PlayerInput : nullptr;
+}
+
+static FString GetProfileSection(ULocalPlayer* localPlayer)
+{
+	return FString::Printf(TEXT("ExtraConfig.InputProfile.%d"), localPlayer->GetControllerId());
+}
+
+UInputProfiles::UInputProfiles(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
+{
+
+}
+
+// -------
+// Actions
+// -------
+
+bool UInputProfiles::AddPlayerActionMapping(APlayerController* player, FName actionName, FKey newKey, bool ctrl, bool shift, bool alt, bool cmd)
+{
+	ULocalPlayer* localPlayer = GetLocalPlayer(player);
+	if (!localPlayer) return false;
+
+	FInputActionKeyMapping newAction(actionName, newKey, shift, ctrl, alt, cmd);
+
+	FInputProfileStore::Get().FindOrAdd(localPlayer).Edit().ActionMappings.AddUnique(newAction);
+
+	//only this player's input sees the change
+	UPlayerInput* playerInput = GetPlayerInput(localPlayer);
+	if (playerInput)
+	{
+		playerInput->ActionMappings.AddUnique(newAction);
+		INC_DWORD_STAT(STAT_ExtraConfig_KeyMapRebuilds);
+		playerInput->ForceRebuildingKeyMaps(false);
+	}
+
+	return true;
+}
+
+bool UInputProfiles::RemovePlayerActionMapping(APlayerController* player, FName actionName, FKey oldKey, bool ctrl, bool shift, bool alt, bool cmd)
+{
+	ULocalPlayer* localPlayer = GetLocalPlayer(player);
+	if (!localPlayer) return false;
+
+	FInputActionKeyMapping oldAction(actionName, oldKey, shift, ctrl, alt, cmd);
+
+	FInputProfileStore::Get().FindOrAdd(localPlayer).Edit().ActionMappings.Remove(oldAction);
+
+	UPlayerInput* playerInput = GetPlayerInput(localPlayer);
+	if (playerInput)
+	{
+		playerInput->ActionMappings.Remove(oldAction);
+		INC_DWORD_STAT(STAT_ExtraConfig_KeyMapRebuilds);
+		playerInput->ForceRebuildingKeyMaps(false);
+	}
+
+	return true;
+}
+
+TArray<FActionMap> UInputProfiles::GetPlayerKeysForAction(APlayerController* player, FName actionName)
+{
+	ULocalPlayer* localPlayer = GetLocalPlayer(player);
+	if (!localPlayer) return TArray<FActionMap>();
+
+	TArray<FActionMap> maps;
+
+	for (const FInputActionKeyMapping& actionMap : FInputProfileStore::Get().FindOrAdd(localPlayer).Get().ActionMappings)
+	{
+		if (actionMap.ActionName == actionName)
+		{
+			maps.Add(FActionMap(actionMap.ActionName, actionMap.Key, actionMap.bShift, actionMap.bCtrl, actionMap.bAlt, actionMap.bCmd));
+		}
+	}
+
+	return maps;
+}
+
+// ----
+// Axis
+// ----
+
+bool UInputProfiles::AddPlayerAxisMapping(APlayerController* player, FName axisName, FKey newKey, float scale)
+{
+	ULocalPlayer* localPlayer = GetLocalPlayer(player);
+	if (!localPlayer) return false;
+
+	FInputAxisKeyMapping newAxis(axisName, newKey, scale);
+
+	FInputProfileStore::Get().FindOrAdd(localPlayer).Edit().AxisMappings.AddUnique(newAxis);
+
+	UPlayerInput* playerInput = GetPlayerInput(localPlayer);
+	if (playerInput)
+	{
+		playerInput->AxisMappings.AddUnique(newAxis);
+		INC_DWORD_STAT(STAT_ExtraConfig_KeyMapRebuilds);
+		playerInput->ForceRebuildingKeyMaps(false);
+	}
+
+	return true;
+}
+
+bool UInputProfiles::RemovePlayerAxisMapping(APlayerController* player, FName axisName, FKey oldKey, float scale)
+{
+	ULocalPlayer* localPlayer = GetLocalPlayer(player);
+	if (!localPlayer) return false;
+
+	FInputAxisKeyMapping oldAxis(axisName, oldKey, scale);
+
+	FInputProfileStore::Get().FindOrAdd(localPlayer).Edit().AxisMappings.Remove(oldAxis);
+
+	UPlayerInput* playerInput = GetPlayerInput(localPlayer);
+	if (playerInput)
+	{
+		playerInput->AxisMappings.Remove(oldAxis);
+		INC_DWORD_STAT(STAT_ExtraConfig_KeyMapRebuilds);
+		playerInput->ForceRebuildingKeyMaps(false);
+	}
+
+	return true;
+}
+
+TArray<FAxisMap> UInputProfiles::GetPlayerKeysForAxis(APlayerController* player, FName axisName)
+{
+	ULocalPlayer* localPlayer = GetLocalPlayer(player);
+	if (!localPlayer) return TArray<FAxisMap>();
+
+	TArray<FAxisMap> maps;
+
+	for (const FInputAxisKeyMapping& axisMap : FInputProfileStore::Get().FindOrAdd(localPlayer).Get().AxisMappings)
+	{
+		if (axisMap.AxisName == axisName)
+		{
+			maps.Add(FAxisMap(axisMap.AxisName, axisMap.Key, axisMap.Scale));
+		}
+	}
+
+	return maps;
+}
+
+// -------
+// Utility
+// -------
+
+bool UInputProfiles::HasCustomProfile(APlayerController* player)
+{
+	ULocalPlayer* localPlayer = GetLocalPlayer(player);
+
+	return localPlayer && FInputProfileStore::Get().HasCustomProfile(localPlayer);
+}
+
+void UInputProfiles::ResetPlayerProfile(APlayerController* player)
+{
+	ULocalPlayer* localPlayer = GetLocalPlayer(player);
+	if (!localPlayer) return;
+
+	FInputProfileStore& store = FInputProfileStore::Get();
+	store.Reset(localPlayer);
+	FInputProfileStore::ApplyToPlayer(localPlayer, store.FindOrAdd(localPlayer).Get());
+}
+
+void UInputProfiles::SavePlayerProfile(APlayerController* player)
+{
+	ULocalPlayer* localPlayer = GetLocalPlayer(player);
+	if (!localPlayer) return;
+
+	FString section = GetProfileSection(localPlayer);
+
+	if (!FInputProfileStore::Get().HasCustomProfile(localPlayer))
+	{
+		IConfigBackend::Get().EmptySection(*section, GGameUserSettingsIni);
+		IConfigBackend::Get().QueueWrite(GGameUserSettingsIni);
+		return;
+	}
+
+	const FInputBindingSet& bindings = FInputProfileStore::Get().FindOrAdd(localPlayer).Get();
+
+	//Name|Key|modifier bits and Name|Key|scale
+	TArray<FString> actions;
+	for (const FInputActionKeyMapping& mapping : bindings.ActionMappings)
+	{
+		actions.Add(FString::Printf(TEXT("%s|%s|%d"), *mapping.ActionName.ToString(), *mapping.Key.ToString(), FInputBindingIndex::MakeModifiers(mapping)));
+	}
+
+	TArray<FString> axes;
+	for (const FInputAxisKeyMapping& mapping : bindings.AxisMappings)
+	{
+		axes.Add(FString::Printf(TEXT("%s|%s|%f"), *mapping.AxisName.ToString(), *mapping.Key.ToString(), mapping.Scale));
+	}
+
+	IConfigBackend& backend = IConfigBackend::Get();
+	backend.SetArray(*section, TEXT("Action"), actions, GGameUserSettingsIni);
+	backend.SetArray(*section, TEXT("Axis"), axes, GGameUserSettingsIni);
+	backend.QueueWrite(GGameUserSettingsIni);
+}
+
+bool UInputProfiles::LoadPlayerProfile(APlayerController* player)
+{
+	ULocalPlayer* localPlayer = GetLocalPlayer(player);
+	if (!localPlayer) return false;
+
+	FString section = GetProfileSection(localPlayer);
+
+	TArray<FString> actions;
+	TArray<FString> axes;
+	int32 found = IConfigBackend::Get().GetArray(*section, TEXT("Action"), actions, GGameUserSettingsIni);
+	found += IConfigBackend::Get().GetArray(*section, TEXT("Axis"), axes, GGameUserSettingsIni);
+
+	if (found == 0)
+	{
+		return false;
+	}
+
+	FInputBindingSet& bindings = FInputProfileStore::Get().FindOrAdd(localPlayer).Edit();
+	bindings.ActionMappings.Reset();
+	bindings.AxisMappings.Reset();
+
+	TArray<FString> parts;
+	for (const FString& entry : actions)
+	{
+		if (entry.ParseIntoArray(parts, TEXT("|"), false) == 3)
+		{
+			uint8 modifiers = (uint8)FCString::Atoi(*parts[2]);
+			bindings.ActionMappings.Add(FInputActionKeyMapping(FName(*parts[0]), FKey(FName(*parts[1])),
+				(modifiers & FInputBindingIndex::Shift) != 0, (modifiers & FInputBindingIndex::Ctrl) != 0,
+				(modifiers & FInputBindingIndex::Alt) != 0, (modifiers & FInputBindingIndex::Cmd) != 0));
+		}
+	}
+
+	for (const FString& entry : axes)
+	{
+		if (entry.ParseIntoArray(parts, TEXT("|"), false) == 3)
+		{
+			bindings.AxisMappings.Add(FInputAxisKeyMapping(FName(*parts[0]), FKey(FName(*parts[1])), FCString::Atof(*parts[2])));
+		}
+	}
+
+	FInputProfileStore::ApplyToPlayer(localPlayer, bindings);
+
+	return true;
+}
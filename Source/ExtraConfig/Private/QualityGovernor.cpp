@@ -0,0 +1,261 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ExtraConfigPrivatePCH.h"
+#include "QualityGovernor.h"
+#include "ConfigNotifications.h"
+#include "ConfigBackend.h"
+#include "RenderCore.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogQualityGovernor, Log, All);
+
+//Order in which settings are given up; stepping back up walks it in reverse
+struct FGovernorStep
+{
+	const TCHAR* CVarName;
+	int32 MinValue;
+	int32 StepSize;
+	//the UGraphicsConfig setting backed by the same console variable, MAX if there is none
+	EGraphicsSetting Setting;
+};
+
+static const FGovernorStep GovernorLadder[] =
+{
+	{ TEXT("r.ScreenPercentage"),			70,	10,	EGraphicsSetting::MAX },
+	{ TEXT("r.AmbientOcclusionLevels"),		0,	1,	EGraphicsSetting::SSAO },
+	{ TEXT("r.SSR.Quality"),				0,	1,	EGraphicsSetting::Reflections },
+	{ TEXT("sg.ShadowQuality"),				1,	1,	EGraphicsSetting::Shadows },
+};
+
+static int32 GetCVarInt(const TCHAR* name, int32 fallback)
+{
+	int32 value = fallback;
+	IConfigBackend::Get().GetCVar(name, value);
+	return value;
+}
+
+static FFrameTimeSample GetEngineFrameTime()
+{
+	return FFrameTimeSample(
+		FApp::GetDeltaTime() * 1000.f,
+		FPlatformTime::ToMilliseconds(GGameThreadTime),
+		FPlatformTime::ToMilliseconds(GRenderThreadTime));
+}
+
+UQualityGovernor::UQualityGovernor(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
+	, TargetFPS(60.f)
+	, WindowSize(60)
+	, DownMargin(0.1f)
+	, UpMargin(0.2f)
+	, MinDwellSeconds(3.f)
+	, bEnabled(false)
+	, SecondsSinceStep(0.f)
+{
+	FrameTimeSource = &GetEngineFrameTime;
+}
+
+UQualityGovernor* UQualityGovernor::CreateQualityGovernor(float targetFPS)
+{
+	UQualityGovernor* governor = NewObject<UQualityGovernor>();
+	governor->TargetFPS = targetFPS;
+	return governor;
+}
+
+void UQualityGovernor::Enable()
+{
+	if (bEnabled)
+	{
+		return;
+	}
+
+	Baseline.Empty(ARRAY_COUNT(GovernorLadder));
+	for (const FGovernorStep& step : GovernorLadder)
+	{
+		Baseline.Add(GetCVarInt(step.CVarName, step.MinValue));
+	}
+	Current = Baseline;
+
+	Window.Empty(WindowSize);
+	SecondsSinceStep = 0.f;
+	bEnabled = true;
+
+	AddToRoot();
+	ConfigChangedHandle = UConfigNotifications::OnConfigChangedNative.AddUObject(this, &UQualityGovernor::OnConfigChanged);
+
+	UE_LOG(LogQualityGovernor, Log, TEXT("Enabled, target %.1f fps"), TargetFPS);
+}
+
+void UQualityGovernor::Disable()
+{
+	if (!bEnabled)
+	{
+		return;
+	}
+
+	for (int32 i = 0; i < Current.Num(); i++)
+	{
+		if (Current[i] != Baseline[i])
+		{
+			ApplyStep(i, Baseline[i], 0.f);
+		}
+	}
+
+	bEnabled = false;
+
+	UConfigNotifications::OnConfigChangedNative.Remove(ConfigChangedHandle);
+	RemoveFromRoot();
+
+	UE_LOG(LogQualityGovernor, Log, TEXT("Disabled"));
+}
+
+void UQualityGovernor::SetFrameTimeSource(TFunction<FFrameTimeSample()> source)
+{
+	FrameTimeSource = source ? source : TFunction<FFrameTimeSample()>(&GetEngineFrameTime);
+}
+
+void UQualityGovernor::AddSample(const FFrameTimeSample& sample)
+{
+	if (!bEnabled || TargetFPS <= 0.f)
+	{
+		return;
+	}
+
+	Window.Add(sample);
+	SecondsSinceStep += sample.FrameMs / 1000.f;
+
+	if (Window.Num() < FMath::Max(WindowSize, 1))
+	{
+		return;
+	}
+
+	FFrameTimeSample average;
+	for (const FFrameTimeSample& entry : Window)
+	{
+		average.FrameMs += entry.FrameMs;
+		average.GameThreadMs += entry.GameThreadMs;
+		average.RenderThreadMs += entry.RenderThreadMs;
+	}
+	average.FrameMs /= Window.Num();
+	average.GameThreadMs /= Window.Num();
+	average.RenderThreadMs /= Window.Num();
+
+	Window.Reset();
+
+	if (SecondsSinceStep < MinDwellSeconds)
+	{
+		return;
+	}
+
+	float targetMs = 1000.f / TargetFPS;
+
+	if (average.FrameMs > targetMs * (1.f + DownMargin))
+	{
+		//lowering render settings won't help if the game thread alone misses the target
+		if (average.GameThreadMs > targetMs * (1.f + DownMargin) && average.RenderThreadMs < average.GameThreadMs)
+		{
+			UE_LOG(LogQualityGovernor, Verbose, TEXT("Game thread bound (%.2f ms game, %.2f ms render), holding"),
+				average.GameThreadMs, average.RenderThreadMs);
+			return;
+		}
+
+		if (!StepDown(average.FrameMs))
+		{
+			UE_LOG(LogQualityGovernor, Verbose, TEXT("%.2f ms over %.2f ms target with nothing left to lower"), average.FrameMs, targetMs);
+		}
+	}
+	else if (average.FrameMs < targetMs * (1.f - UpMargin))
+	{
+		StepUp(average.FrameMs);
+	}
+}
+
+bool UQualityGovernor::StepDown(float averageMs)
+{
+	for (int32 i = 0; i < Current.Num(); i++)
+	{
+		if (Current[i] > GovernorLadder[i].MinValue)
+		{
+			ApplyStep(i, FMath::Max(Current[i] - GovernorLadder[i].StepSize, GovernorLadder[i].MinValue), averageMs);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool UQualityGovernor::StepUp(float averageMs)
+{
+	for (int32 i = Current.Num() - 1; i >= 0; i--)
+	{
+		if (Current[i] < Baseline[i])
+		{
+			ApplyStep(i, FMath::Min(Current[i] + GovernorLadder[i].StepSize, Baseline[i]), averageMs);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void UQualityGovernor::ApplyStep(int32 stepIndex, int32 newValue, float averageMs)
+{
+	const FGovernorStep& step = GovernorLadder[stepIndex];
+	int32 oldValue = Current[stepIndex];
+
+	IConfigBackend::Get().SetCVar(step.CVarName, newValue);
+
+	Current[stepIndex] = newValue;
+	SecondsSinceStep = 0.f;
+
+	UE_LOG(LogQualityGovernor, Log, TEXT("%s %d -> %d (average frame %.2f ms)"), step.CVarName, oldValue, newValue, averageMs);
+
+	OnDecisionNative.Broadcast(FName(step.CVarName), oldValue, newValue, averageMs);
+	OnDecision.Broadcast(FName(step.CVarName), oldValue, newValue, averageMs);
+}
+
+void UQualityGovernor::OnConfigChanged(int32 changedConfig, int32 changedGraphicsSettings)
+{
+	for (int32 i = 0; i < Current.Num(); i++)
+	{
+		EGraphicsSetting setting = GovernorLadder[i].Setting;
+		if (setting == EGraphicsSetting::MAX || !UConfigNotifications::HasGraphicsSettingChange(changedGraphicsSettings, setting))
+		{
+			continue;
+		}
+
+		//a value equal to ours is the governor's own change seen through an ini without the key
+		int32 value = UGraphicsConfig::GetGraphicsSetting(setting);
+		if (value == Current[i])
+		{
+			continue;
+		}
+
+		UE_LOG(LogQualityGovernor, Log, TEXT("%s changed to %d by the player, using it as the new ceiling"), GovernorLadder[i].CVarName, value);
+
+		//UGraphicsConfig has applied it to the live console variable already
+		Baseline[i] = value;
+		Current[i] = GetCVarInt(GovernorLadder[i].CVarName, value);
+		SecondsSinceStep = 0.f;
+	}
+}
+
+void UQualityGovernor::Tick(float DeltaTime)
+{
+	AddSample(FrameTimeSource());
+}
+
+bool UQualityGovernor::IsTickable() const
+{
+	return bEnabled && !HasAnyFlags(RF_ClassDefaultObject);
+}
+
+TStatId UQualityGovernor::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UQualityGovernor, STATGROUP_Tickables);
+}
+
+void UQualityGovernor::BeginDestroy()
+{
+	Disable();
+
+	Super::BeginDestroy();
+}
@@ -0,0 +1,134 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ExtraConfigPrivatePCH.h"
+#include "SettingsCache.h"
+#include "SettingsProfile.h"
+#include "GraphicsSettingDescriptors.h"
+
+//File layout: magic, version, source hash, then the graphics settings
+static const uint32 CacheMagic = 0x43435845;	//"EXCC"
+static const int32 CacheVersion = 2;
+
+FString FSettingsCache::GetFilename()
+{
+	return FPaths::GameSavedDir() / TEXT("ExtraConfigCache.bin");
+}
+
+uint32 FSettingsCache::HashSources()
+{
+	//a hit also tells delta persistence these files are already migrated, hence Game and Input;
+	//settings missing from [ConsoleVariables] come from the scalability groups
+	const FString* sources[] = { &GEngineIni, &GGameIni, &GGameUserSettingsIni, &GInputIni, &GScalabilityIni };
+
+	//the descriptor ranges are part of the format, so a build with other settings misses
+	uint32 hash = (uint32)EGraphicsSetting::MAX;
+	for (const FGraphicsSettingDescriptor& desc : GraphicsSettingDescriptors)
+	{
+		int32 range[] = { desc.MinValue, desc.MaxValue, desc.DefaultValue };
+		hash = FCrc::MemCrc32(range, sizeof(range), hash);
+	}
+
+	//the Base, Default and platform layers each file was built from, then the saved file itself
+	TArray<FString> filenames;
+	for (const FString* source : sources)
+	{
+		const FConfigFile* file = GConfig->Find(*source, false);
+		if (file)
+		{
+			for (const FIniFilename& layer : file->SourceIniHierarchy)
+			{
+				filenames.AddUnique(layer.Filename);
+			}
+		}
+
+		filenames.AddUnique(*source);
+	}
+
+	TArray<uint8> bytes;
+	for (const FString& filename : filenames)
+	{
+		bytes.Reset();
+		FFileHelper::LoadFileToArray(bytes, *filename, FILEREAD_Silent);
+
+		hash = FCrc::StrCrc32(*filename, hash);
+		hash = FCrc::MemCrc32(bytes.GetData(), bytes.Num(), hash);
+	}
+
+	return hash;
+}
+
+bool FSettingsCache::Read(FGraphicsSettings& outGraphics)
+{
+	TArray<uint8> bytes;
+	if (!FFileHelper::LoadFileToArray(bytes, *GetFilename(), FILEREAD_Silent))
+	{
+		return false;
+	}
+
+	FMemoryReader reader(bytes);
+
+	uint32 magic = 0;
+	int32 version = 0;
+	uint32 hash = 0;
+	reader << magic << version << hash;
+
+	if (magic != CacheMagic || version != CacheVersion || hash != HashSources())
+	{
+		UE_LOG(LogExtraConfig, Log, TEXT("Settings cache is stale, reading the ini files"));
+		return false;
+	}
+
+	SerializeGraphicsSettings(reader, outGraphics);
+
+	if (reader.IsError())
+	{
+		UE_LOG(LogExtraConfig, Log, TEXT("Settings cache is damaged, reading the ini files"));
+		return false;
+	}
+
+	return true;
+}
+
+bool FSettingsCache::Load()
+{
+	double start = FPlatformTime::Seconds();
+
+	FGraphicsSettings graphics;
+	if (!Read(graphics))
+	{
+		return false;
+	}
+
+	UGraphicsConfig::PrimeGraphicsSettings(graphics);
+
+	UE_LOG(LogExtraConfig, Log, TEXT("Loaded settings cache in %.2f ms"), (FPlatformTime::Seconds() - start) * 1000.0);
+
+	return true;
+}
+
+void FSettingsCache::Save()
+{
+	if (GExitPurge || !GConfig)
+	{
+		return;
+	}
+
+	FGraphicsSettings graphics = UGraphicsConfig::GetGraphicsSettings();
+
+	TArray<uint8> bytes;
+	FMemoryWriter writer(bytes);
+
+	uint32 magic = CacheMagic;
+	int32 version = CacheVersion;
+	uint32 hash = HashSources();
+	writer << magic << version << hash;
+	SerializeGraphicsSettings(writer, graphics);
+
+	FString filename = GetFilename();
+	FString tempFilename = filename + TEXT(".tmp");
+
+	if (!FFileHelper::SaveArrayToFile(bytes, *tempFilename) || !IFileManager::Get().Move(*filename, *tempFilename))
+	{
+		UE_LOG(LogExtraConfig, Warning, TEXT("Failed to write settings cache to %s"), *filename);
+	}
+}
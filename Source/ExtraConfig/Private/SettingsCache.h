@@ -0,0 +1,38 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "GraphicsConfig.h"
+
+/**
+ * Binary copy of the graphics settings, written at shutdown and read back at startup instead of
+ * looking each setting up in the engine ini. It is keyed by a hash of every layer of the ini files
+ * the plugin manages, so an edit made outside the plugin, a patched Default or Base ini, or a write
+ * that never completed makes it miss and everything is read from the ini files as before.
+ *
+ * Mappings and the display mode are not cached: the engine has already loaded them from the ini
+ * files into UInputSettings and UGameUserSettings before the plugin starts, so there is nothing
+ * left to skip.
+ */
+class FSettingsCache
+{
+public:
+
+	/**
+	 * Validates the cache against the ini files on disk and, if it matches, primes the graphics
+	 * settings from it. Returns false on a miss.
+	 */
+	static bool Load();
+
+	/** Validates the cache and reads it without priming anything. Returns false on a miss. */
+	static bool Read(FGraphicsSettings& outGraphics);
+
+	/** Writes the cache for the current config. Call once pending ini writes have reached disk. */
+	static void Save();
+
+	static FString GetFilename();
+
+private:
+
+	static uint32 HashSources();
+};
@@ -0,0 +1,32 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "GraphicsConfig.h"
+#include "GameFramework/InputSettings.h"
+
+/** Everything a settings profile restores, with a compact binary form. */
+struct FSettingsProfile
+{
+	FName Name;
+
+	FGraphicsSettings Graphics;
+
+	FIntPoint Resolution;
+	EScreenMode ScreenMode;
+	int32 RefreshRate;
+
+	TArray<FInputActionKeyMapping> ActionMappings;
+	TArray<FInputAxisKeyMapping> AxisMappings;
+	TArray<FInputAxisConfigEntry> AxisConfig;
+
+	FSettingsProfile() : Resolution(0, 0), ScreenMode(EScreenMode::Window), RefreshRate(0) {}
+
+	/** Fills the profile from the live config. */
+	static void Capture(FSettingsProfile& profile);
+
+	friend FArchive& operator<<(FArchive& ar, FSettingsProfile& profile);
+};
+
+/** Reads or writes the graphics fields in the compact form profiles and the startup cache share. */
+void SerializeGraphicsSettings(FArchive& ar, FGraphicsSettings& graphics);
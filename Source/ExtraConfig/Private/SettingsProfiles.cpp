@@ -0,0 +1,416 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ExtraConfigPrivatePCH.h"
+#include "SettingsProfiles.h"
+#include "SettingsProfile.h"
+#include "ConfigBackend.h"
+#include "InputConfig.h"
+#include "InputBindingIndex.h"
+#include "GraphicsSettingDescriptors.h"
+
+//File layout: magic, version, active profile name, then the profiles
+static const uint32 ProfilesMagic = 0x50435845;	//"EXCP"
+static const int32 ProfilesVersion = 1;
+
+static TArray<FSettingsProfile> Profiles;
+static FName ActiveProfile;
+static bool bProfilesLoaded = false;
+
+//Reads or writes an array length, flagging lengths a damaged file couldn't possibly hold
+static bool SerializeCount(FArchive& ar, int32& count)
+{
+	ar << count;
+
+	if (ar.IsLoading() && (count < 0 || count > ar.TotalSize()))
+	{
+		ar.ArIsError = true;
+		return false;
+	}
+
+	return !ar.IsError();
+}
+
+void SerializeGraphicsSettings(FArchive& ar, FGraphicsSettings& graphics)
+{
+	//one byte per setting, led by the count so settings added later read back as defaults
+	uint8 settingCount = (uint8)EGraphicsSetting::MAX;
+	ar << settingCount;
+
+	for (int32 i = 0; i < settingCount; i++)
+	{
+		uint8 value = 0;
+
+		if (i < (int32)EGraphicsSetting::MAX)
+		{
+			const FGraphicsSettingDescriptor& desc = GraphicsSettingDescriptors[i];
+
+			if (ar.IsSaving())
+			{
+				value = (uint8)desc.Get(graphics);
+			}
+			ar << value;
+			if (ar.IsLoading())
+			{
+				desc.Set(graphics, desc.Clamp(value));
+			}
+		}
+		else
+		{
+			ar << value;
+		}
+	}
+}
+
+FArchive& operator<<(FArchive& ar, FSettingsProfile& profile)
+{
+	ar << profile.Name;
+
+	SerializeGraphicsSettings(ar, profile.Graphics);
+
+	uint8 screenMode = (uint8)profile.ScreenMode;
+	ar << profile.Resolution << screenMode << profile.RefreshRate;
+	profile.ScreenMode = (EScreenMode)screenMode;
+
+	int32 count = profile.ActionMappings.Num();
+	if (!SerializeCount(ar, count))
+	{
+		return ar;
+	}
+	if (ar.IsLoading())
+	{
+		profile.ActionMappings.SetNum(count);
+	}
+	for (FInputActionKeyMapping& mapping : profile.ActionMappings)
+	{
+		FName keyName = mapping.Key.GetFName();
+		uint8 modifiers = FInputBindingIndex::MakeModifiers(mapping);
+		ar << mapping.ActionName << keyName << modifiers;
+
+		if (ar.IsLoading())
+		{
+			mapping.Key = FKey(keyName);
+			mapping.bShift = (modifiers & FInputBindingIndex::Shift) != 0;
+			mapping.bCtrl = (modifiers & FInputBindingIndex::Ctrl) != 0;
+			mapping.bAlt = (modifiers & FInputBindingIndex::Alt) != 0;
+			mapping.bCmd = (modifiers & FInputBindingIndex::Cmd) != 0;
+		}
+	}
+
+	count = profile.AxisMappings.Num();
+	if (!SerializeCount(ar, count))
+	{
+		return ar;
+	}
+	if (ar.IsLoading())
+	{
+		profile.AxisMappings.SetNum(count);
+	}
+	for (FInputAxisKeyMapping& mapping : profile.AxisMappings)
+	{
+		FName keyName = mapping.Key.GetFName();
+		ar << mapping.AxisName << keyName << mapping.Scale;
+
+		if (ar.IsLoading())
+		{
+			mapping.Key = FKey(keyName);
+		}
+	}
+
+	count = profile.AxisConfig.Num();
+	if (!SerializeCount(ar, count))
+	{
+		return ar;
+	}
+	if (ar.IsLoading())
+	{
+		profile.AxisConfig.SetNum(count);
+	}
+	for (FInputAxisConfigEntry& entry : profile.AxisConfig)
+	{
+		uint8 invert = entry.AxisProperties.bInvert ? 1 : 0;
+		ar << entry.AxisKeyName << entry.AxisProperties.DeadZone << entry.AxisProperties.Sensitivity << entry.AxisProperties.Exponent << invert;
+		entry.AxisProperties.bInvert = invert != 0;
+	}
+
+	return ar;
+}
+
+static void LoadProfiles()
+{
+	if (bProfilesLoaded)
+	{
+		return;
+	}
+
+	bProfilesLoaded = true;
+
+	TArray<uint8> bytes;
+	if (!FFileHelper::LoadFileToArray(bytes, *USettingsProfiles::GetProfilesFilename(), FILEREAD_Silent))
+	{
+		return;
+	}
+
+	FMemoryReader reader(bytes);
+
+	uint32 magic = 0;
+	int32 version = 0;
+	reader << magic << version;
+
+	if (magic != ProfilesMagic || version != ProfilesVersion)
+	{
+		UE_LOG(LogExtraConfig, Warning, TEXT("Ignoring settings profiles with unknown format in %s"), *USettingsProfiles::GetProfilesFilename());
+		return;
+	}
+
+	reader << ActiveProfile << Profiles;
+
+	if (reader.IsError())
+	{
+		UE_LOG(LogExtraConfig, Warning, TEXT("Settings profiles in %s are truncated"), *USettingsProfiles::GetProfilesFilename());
+		Profiles.Empty();
+		ActiveProfile = NAME_None;
+	}
+}
+
+static void SaveProfiles()
+{
+	TArray<uint8> bytes;
+	FMemoryWriter writer(bytes);
+
+	uint32 magic = ProfilesMagic;
+	int32 version = ProfilesVersion;
+	writer << magic << version << ActiveProfile << Profiles;
+
+	//same temp-then-rename as the ini writes, so a crash never truncates the file
+	FString filename = USettingsProfiles::GetProfilesFilename();
+	FString tempFilename = filename + TEXT(".tmp");
+
+	if (!FFileHelper::SaveArrayToFile(bytes, *tempFilename) || !IFileManager::Get().Move(*filename, *tempFilename))
+	{
+		UE_LOG(LogExtraConfig, Warning, TEXT("Failed to write settings profiles to %s"), *filename);
+	}
+}
+
+static FSettingsProfile* FindProfile(FName profileName)
+{
+	return Profiles.FindByPredicate([profileName](const FSettingsProfile& profile) { return profile.Name == profileName; });
+}
+
+void FSettingsProfile::Capture(FSettingsProfile& profile)
+{
+	profile.Graphics = UGraphicsConfig::GetGraphicsSettings();
+
+	FInt2D res = UGraphicsConfig::GetCurrentResolution();
+	profile.Resolution = FIntPoint(res.X, res.Y);
+	profile.ScreenMode = UGraphicsConfig::GetScreenMode();
+	profile.RefreshRate = UGraphicsConfig::GetRefreshRate();
+
+	const UInputSettings* Settings = IConfigBackend::Get().GetInputSettings();
+	profile.ActionMappings = Settings->ActionMappings;
+	profile.AxisMappings = Settings->AxisMappings;
+	profile.AxisConfig = Settings->AxisConfig;
+}
+
+static int32 CountBits(int32 mask)
+{
+	int32 count = 0;
+	for (; mask; mask &= mask - 1)
+	{
+		count++;
+	}
+	return count;
+}
+
+//Edits only the mappings that differ, so SaveChanges rebuilds only their names
+static int32 ApplyBindings(const FSettingsProfile& profile)
+{
+	const UInputSettings* Settings = IConfigBackend::Get().GetInputSettings();
+	int32 changes = 0;
+
+	//sets of both sides, so each difference is a lookup rather than a scan
+	TSet<FInputActionKeyMapping, FActionMappingKeyFuncs> actions;
+	actions.Append(Settings->ActionMappings);
+	TSet<FInputActionKeyMapping, FActionMappingKeyFuncs> profileActions;
+	profileActions.Append(profile.ActionMappings);
+	for (const FInputActionKeyMapping& mapping : actions)
+	{
+		if (!profileActions.Contains(mapping))
+		{
+			UInputConfig::RemoveActionMapping(mapping.ActionName, mapping.Key, mapping.bCtrl, mapping.bShift, mapping.bAlt, mapping.bCmd);
+			changes++;
+		}
+	}
+	for (const FInputActionKeyMapping& mapping : profile.ActionMappings)
+	{
+		if (!actions.Contains(mapping))
+		{
+			UInputConfig::AddActionMapping(mapping.ActionName, mapping.Key, mapping.bCtrl, mapping.bShift, mapping.bAlt, mapping.bCmd);
+			changes++;
+		}
+	}
+
+	TSet<FInputAxisKeyMapping, FAxisMappingKeyFuncs> axes;
+	axes.Append(Settings->AxisMappings);
+	TSet<FInputAxisKeyMapping, FAxisMappingKeyFuncs> profileAxes;
+	profileAxes.Append(profile.AxisMappings);
+	for (const FInputAxisKeyMapping& mapping : axes)
+	{
+		if (!profileAxes.Contains(mapping))
+		{
+			UInputConfig::RemoveAxisMapping(mapping.AxisName, mapping.Key, mapping.Scale);
+			changes++;
+		}
+	}
+	for (const FInputAxisKeyMapping& mapping : profile.AxisMappings)
+	{
+		if (!axes.Contains(mapping))
+		{
+			UInputConfig::AddAxisMapping(mapping.AxisName, mapping.Key, mapping.Scale);
+			changes++;
+		}
+	}
+
+	TSet<FName> profileAnalogKeys;
+	for (const FInputAxisConfigEntry& entry : profile.AxisConfig)
+	{
+		profileAnalogKeys.Add(entry.AxisKeyName);
+	}
+
+	TSet<FName> analogKeys;
+	for (const FKey& key : UInputConfig::GetAnalogKeys())
+	{
+		analogKeys.Add(key.GetFName());
+		if (!profileAnalogKeys.Contains(key.GetFName()))
+		{
+			UInputConfig::RemoveAnalogConfig(key);
+			changes++;
+		}
+	}
+	for (const FInputAxisConfigEntry& entry : profile.AxisConfig)
+	{
+		FKey key(entry.AxisKeyName);
+		const FInputAxisProperties& properties = entry.AxisProperties;
+		FAnalogConfig current = UInputConfig::GetConfigForAnalog(key);
+
+		bool bSame = analogKeys.Contains(entry.AxisKeyName) && current.Invert == properties.bInvert && current.DeadZone == properties.DeadZone
+			&& current.Exponent == properties.Exponent && current.Multiplier == properties.Sensitivity;
+
+		if (!bSame)
+		{
+			UInputConfig::AddAnalogConfig(key, properties.bInvert, properties.DeadZone, properties.Sensitivity, properties.Exponent);
+			changes++;
+		}
+	}
+
+	return changes;
+}
+
+USettingsProfiles::USettingsProfiles(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
+{
+
+}
+
+FString USettingsProfiles::GetProfilesFilename()
+{
+	return FPaths::GameSavedDir() / TEXT("ExtraConfigProfiles.bin");
+}
+
+void USettingsProfiles::SaveSettingsProfile(FName profileName)
+{
+	LoadProfiles();
+
+	FSettingsProfile* profile = FindProfile(profileName);
+	if (!profile)
+	{
+		profile = &Profiles[Profiles.AddDefaulted()];
+		profile->Name = profileName;
+	}
+
+	FSettingsProfile::Capture(*profile);
+	ActiveProfile = profileName;
+
+	SaveProfiles();
+}
+
+int32 USettingsProfiles::ApplySettingsProfile(FName profileName)
+{
+	LoadProfiles();
+
+	const FSettingsProfile* profile = FindProfile(profileName);
+	if (!profile)
+	{
+		return -1;
+	}
+
+	//diffed against the live config rather than the stored active profile, which may have been edited since
+	int32 changes = CountBits(UGraphicsConfig::DiffGraphicsSettings(UGraphicsConfig::GetGraphicsSettings(), profile->Graphics));
+
+	UGraphicsConfig::BeginGraphicsChanges();
+
+	UGraphicsConfig::ApplyGraphicsSettings(profile->Graphics);
+
+	FInt2D res = UGraphicsConfig::GetCurrentResolution();
+	if (res.X != profile->Resolution.X || res.Y != profile->Resolution.Y
+		|| UGraphicsConfig::GetScreenMode() != profile->ScreenMode || UGraphicsConfig::GetRefreshRate() != profile->RefreshRate)
+	{
+		UGraphicsConfig::ApplyDisplayMode(profile->Resolution.X, profile->Resolution.Y, profile->ScreenMode, profile->RefreshRate);
+		changes++;
+	}
+
+	UGraphicsConfig::CommitGraphicsChanges();
+
+	int32 bindingChanges = ApplyBindings(*profile);
+	if (bindingChanges > 0)
+	{
+		UInputConfig::SaveChanges();
+	}
+	changes += bindingChanges;
+
+	if (ActiveProfile != profileName)
+	{
+		ActiveProfile = profileName;
+		SaveProfiles();
+	}
+
+	return changes;
+}
+
+bool USettingsProfiles::DeleteSettingsProfile(FName profileName)
+{
+	LoadProfiles();
+
+	int32 removed = Profiles.RemoveAll([profileName](const FSettingsProfile& profile) { return profile.Name == profileName; });
+	if (removed == 0)
+	{
+		return false;
+	}
+
+	if (ActiveProfile == profileName)
+	{
+		ActiveProfile = NAME_None;
+	}
+
+	SaveProfiles();
+
+	return true;
+}
+
+TArray<FName> USettingsProfiles::GetSettingsProfileNames()
+{
+	LoadProfiles();
+
+	TArray<FName> names;
+	for (const FSettingsProfile& profile : Profiles)
+	{
+		names.Add(profile.Name);
+	}
+
+	return names;
+}
+
+FName USettingsProfiles::GetActiveSettingsProfile()
+{
+	LoadProfiles();
+
+	return ActiveProfile;
+}
@@ -0,0 +1,116 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ExtraConfigPrivatePCH.h"
+#include "AnalogResponseCurve.h"
+#include "AutomationTest.h"
+
+static FInputAxisProperties MakeProperties(float deadZone, float exponent, float sensitivity, bool bInvert)
+{
+	FInputAxisProperties properties;
+	properties.DeadZone = deadZone;
+	properties.Exponent = exponent;
+	properties.Sensitivity = sensitivity;
+	properties.bInvert = bInvert;
+	return properties;
+}
+
+//Largest difference between the curve, single and batched, and the exact formula over the samples
+static float MeasureError(const FInputAxisProperties& properties, const TArray<float>& samples)
+{
+	FAnalogResponseCurve curve(properties);
+
+	TArray<float> batch;
+	batch.SetNumUninitialized(samples.Num());
+	curve.EvaluateBatch(samples.GetData(), batch.GetData(), samples.Num());
+
+	float maxError = 0.f;
+	for (int32 i = 0; i < samples.Num(); i++)
+	{
+		float exact = FAnalogResponseCurve::EvaluateExact(properties, samples[i]);
+		maxError = FMath::Max(maxError, FMath::Abs(curve.Evaluate(samples[i]) - exact));
+		maxError = FMath::Max(maxError, FMath::Abs(batch[i] - exact));
+	}
+
+	return maxError;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAnalogResponseCurveAccuracyTest, "ExtraConfig.AnalogResponseCurve.Accuracy", EAutomationTestFlags::ATF_Editor | EAutomationTestFlags::ATF_Game)
+
+bool FAnalogResponseCurveAccuracyTest::RunTest(const FString& Parameters)
+{
+	static const float DeadZones[] = { 0.f, 0.05f, 0.2f, 0.5f, 0.9f };
+	static const float Exponents[] = { 0.1f, 0.25f, 0.5f, 0.9f, 1.f, 1.5f, 2.f, 3.f, 10.f };
+
+	for (float deadZone : DeadZones)
+	{
+		//a uniform sweep plus a dense one across the dead zone kink, on both sides of zero
+		TArray<float> samples;
+		for (int32 i = -2000; i <= 2000; i++)
+		{
+			samples.Add(i / 2000.f);
+		}
+		for (int32 i = -500; i <= 500; i++)
+		{
+			float offset = i * 1e-5f;
+			samples.Add(deadZone + offset);
+			samples.Add(-deadZone - offset);
+		}
+
+		for (float exponent : Exponents)
+		{
+			FInputAxisProperties properties = MakeProperties(deadZone, exponent, 1.f, false);
+			float error = MeasureError(properties, samples);
+
+			TestTrue(FString::Printf(TEXT("Dead zone %.2f, exponent %.2f: error %g within %g"), deadZone, exponent, error, FAnalogResponseCurve::MaxError),
+				error <= FAnalogResponseCurve::MaxError);
+		}
+	}
+
+	//sensitivity and invert scale the error bound
+	FInputAxisProperties scaled = MakeProperties(0.15f, 0.5f, 4.f, true);
+	TArray<float> sweep;
+	for (int32 i = -1000; i <= 1000; i++)
+	{
+		sweep.Add(i / 1000.f);
+	}
+	TestTrue(TEXT("Sensitivity 4, inverted"), MeasureError(scaled, sweep) <= FAnalogResponseCurve::MaxError * 4.f);
+
+	//samples outside [-1, 1] use the exact formula
+	TArray<float> outside;
+	outside.Add(-3.f);
+	outside.Add(1.5f);
+	outside.Add(12.f);
+	outside.Add(0.5f);
+	TestTrue(TEXT("Outside the table"), MeasureError(scaled, outside) <= FAnalogResponseCurve::MaxError * 4.f);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAnalogResponseCurveClampTest, "ExtraConfig.AnalogResponseCurve.Clamp", EAutomationTestFlags::ATF_Editor | EAutomationTestFlags::ATF_Game)
+
+bool FAnalogResponseCurveClampTest::RunTest(const FString& Parameters)
+{
+	FInputAxisProperties properties = MakeProperties(1.f, -2.f, 1.f, false);
+	TestTrue(TEXT("Out of range values are clamped"), FAnalogResponseCurve::ClampProperties(properties));
+	TestEqual(TEXT("Dead zone"), properties.DeadZone, FAnalogResponseCurve::MaxDeadZone);
+	TestEqual(TEXT("Exponent"), properties.Exponent, 1.f);
+
+	FInputAxisProperties valid = MakeProperties(0.25f, 2.f, 1.f, false);
+	TestFalse(TEXT("Valid values are left alone"), FAnalogResponseCurve::ClampProperties(valid));
+
+	//a dead zone of 1 and a zero exponent would divide by zero and raise zero to a negative power
+	static const float Samples[] = { -1.f, -0.5f, 0.f, 0.5f, 0.995f, 1.f };
+	FInputAxisProperties degenerate[] = { MakeProperties(1.f, 2.f, 1.f, false), MakeProperties(1.5f, 0.f, 1.f, false), MakeProperties(0.f, -1.f, 1.f, true) };
+
+	for (const FInputAxisProperties& config : degenerate)
+	{
+		FAnalogResponseCurve curve(config);
+		for (float sample : Samples)
+		{
+			TestTrue(FString::Printf(TEXT("Dead zone %.2f, exponent %.2f at %.3f is finite"), config.DeadZone, config.Exponent, sample),
+				FMath::IsFinite(curve.Evaluate(sample)) && FMath::IsFinite(FAnalogResponseCurve::EvaluateExact(config, sample)));
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,124 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ExtraConfigPrivatePCH.h"
+#include "ConfigDelta.h"
+#include "AutomationTest.h"
+
+//Every value of every key in the section, sorted, so arrays compare regardless of entry order
+static FString DescribeSection(const FConfigSection* section)
+{
+	if (!section)
+	{
+		return FString();
+	}
+
+	TArray<FName> keys;
+	section->GetKeys(keys);
+	keys.Sort([](const FName& a, const FName& b) { return a.ToString() < b.ToString(); });
+
+	FString text;
+	TArray<FString> values;
+	for (const FName& key : keys)
+	{
+		values.Reset();
+		section->MultiFind(key, values, true);
+		values.Sort([](const FString& a, const FString& b) { return a.Compare(b, ESearchCase::CaseSensitive) < 0; });
+
+		for (const FString& value : values)
+		{
+			text += FString::Printf(TEXT("%s=%s\n"), *key.ToString(), *value);
+		}
+	}
+
+	return text;
+}
+
+//Loads the delta over the defaults the way the engine layers a saved ini, and compares with current
+static void TestRoundTrip(FAutomationTestBase& test, const FString& what, const FString& defaultsText, const FString& currentText)
+{
+	FConfigFile defaults;
+	defaults.CombineFromBuffer(defaultsText);
+
+	FConfigFile current;
+	current.CombineFromBuffer(currentText);
+
+	FString delta = FConfigDelta::MakeDeltaText(defaults, current);
+
+	FConfigFile loaded;
+	loaded.CombineFromBuffer(defaultsText);
+	loaded.CombineFromBuffer(delta);
+
+	//FString's == ignores case, and casing is one of the things the delta has to carry
+	for (const auto& section : current)
+	{
+		FString expected = DescribeSection(&section.Value);
+		FString actual = DescribeSection(loaded.Find(section.Key));
+
+		if (!actual.Equals(expected, ESearchCase::CaseSensitive))
+		{
+			test.AddError(FString::Printf(TEXT("%s: [%s] after loading the delta was\n%sinstead of\n%sfrom the delta\n%s"),
+				*what, *section.Key, *actual, *expected, *delta));
+		}
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FConfigDeltaRoundTripTest, "ExtraConfig.ConfigDelta.RoundTrip", EAutomationTestFlags::ATF_Editor | EAutomationTestFlags::ATF_Game)
+
+bool FConfigDeltaRoundTripTest::RunTest(const FString& Parameters)
+{
+	const FString defaultsText =
+		TEXT("[ExtraConfigDeltaTest]") LINE_TERMINATOR
+		TEXT("Scalar=1") LINE_TERMINATOR
+		TEXT("Unchanged=Same") LINE_TERMINATOR
+		TEXT("+Actions=Jump") LINE_TERMINATOR
+		TEXT("+Actions=Fire") LINE_TERMINATOR
+		TEXT(".Actions=Fire") LINE_TERMINATOR
+		TEXT("+Axes=MoveX") LINE_TERMINATOR
+		TEXT("+Axes=MoveY") LINE_TERMINATOR
+		TEXT("+Paths=A") LINE_TERMINATOR
+		TEXT("+Paths=B") LINE_TERMINATOR
+		TEXT("+Names=Crouch") LINE_TERMINATOR
+		TEXT("+Names=Prone") LINE_TERMINATOR;
+
+	//identical files need no delta at all
+	FConfigFile defaults;
+	defaults.CombineFromBuffer(defaultsText);
+	TestEqual(TEXT("Delta of the defaults"), FConfigDelta::MakeDeltaText(defaults, defaults), FString());
+
+	TestRoundTrip(*this, TEXT("Changed scalar"), defaultsText,
+		FString(defaultsText).Replace(TEXT("Scalar=1"), TEXT("Scalar=2")));
+
+	//Fire is listed twice in the defaults: each - only removes one of them
+	TestRoundTrip(*this, TEXT("One duplicate removed"), defaultsText,
+		FString(defaultsText).Replace(TEXT(".Actions=Fire") LINE_TERMINATOR, TEXT("")));
+
+	TestRoundTrip(*this, TEXT("Both duplicates removed"), defaultsText,
+		FString(defaultsText).Replace(TEXT("+Actions=Fire") LINE_TERMINATOR TEXT(".Actions=Fire") LINE_TERMINATOR, TEXT("")));
+
+	//+ won't add a value that is already there, so extra copies need .
+	TestRoundTrip(*this, TEXT("Duplicates added"), defaultsText,
+		defaultsText + TEXT("[ExtraConfigDeltaTest]") LINE_TERMINATOR
+		TEXT(".Actions=Jump") LINE_TERMINATOR
+		TEXT(".Actions=Jump") LINE_TERMINATOR
+		TEXT(".Actions=Fire") LINE_TERMINATOR
+		TEXT("+Actions=Use") LINE_TERMINATOR
+		TEXT(".Actions=Use") LINE_TERMINATOR);
+
+	TestRoundTrip(*this, TEXT("Emptied array"), defaultsText,
+		FString(defaultsText).Replace(TEXT("+Axes=MoveX") LINE_TERMINATOR TEXT("+Axes=MoveY") LINE_TERMINATOR, TEXT("")));
+
+	//one value left out of two goes through the array path rather than Key=Value
+	TestRoundTrip(*this, TEXT("Array down to one entry"), defaultsText,
+		FString(defaultsText).Replace(TEXT("+Paths=A") LINE_TERMINATOR, TEXT("")));
+
+	//the engine's - and + ignore case, so a value whose casing changed must be removed before it is added
+	TestRoundTrip(*this, TEXT("Changed casing"), defaultsText,
+		FString(defaultsText).Replace(TEXT("+Names=Crouch"), TEXT("+Names=crouch"), ESearchCase::CaseSensitive));
+
+	TestRoundTrip(*this, TEXT("New section"), defaultsText,
+		defaultsText + TEXT("[ExtraConfigDeltaTest.New]") LINE_TERMINATOR
+		TEXT("+Actions=Jump") LINE_TERMINATOR
+		TEXT(".Actions=Jump") LINE_TERMINATOR);
+
+	return true;
+}
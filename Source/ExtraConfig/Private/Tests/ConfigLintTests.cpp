@@ -0,0 +1,172 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ExtraConfigPrivatePCH.h"
+#include "ConfigLint.h"
+#include "AnalogResponseCurve.h"
+#include "AutomationTest.h"
+
+static const TCHAR* InputSection = TEXT("[/Script/Engine.InputSettings]") LINE_TERMINATOR;
+
+static FString MakeActionLine(const TCHAR* op, const TCHAR* name, const TCHAR* key, bool shift)
+{
+	return FString::Printf(TEXT("%sActionMappings=(ActionName=\"%s\",Key=%s,bShift=%s,bCtrl=False,bAlt=False,bCmd=False)") LINE_TERMINATOR,
+		op, name, key, shift ? TEXT("True") : TEXT("False"));
+}
+
+static FString MakeAxisLine(const TCHAR* name, const TCHAR* key, const TCHAR* scale)
+{
+	return FString::Printf(TEXT("+AxisMappings=(AxisName=\"%s\",Key=%s,Scale=%s)") LINE_TERMINATOR, name, key, scale);
+}
+
+static int32 CountLines(const FString& text)
+{
+	TArray<FString> lines;
+	return text.ParseIntoArrayLines(lines);
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FConfigLintRemoveThenAddTest, "ExtraConfig.ConfigLint.RemoveThenAdd", EAutomationTestFlags::ATF_Editor | EAutomationTestFlags::ATF_Game)
+
+bool FConfigLintRemoveThenAddTest::RunTest(const FString& Parameters)
+{
+	FString output;
+
+	//the second + puts back what the - took out, so all three lines matter
+	FString mapping = FString(InputSection)
+		+ MakeActionLine(TEXT("+"), TEXT("Jump"), TEXT("SpaceBar"), false)
+		+ MakeActionLine(TEXT("-"), TEXT("Jump"), TEXT("SpaceBar"), false)
+		+ MakeActionLine(TEXT("+"), TEXT("Jump"), TEXT("SpaceBar"), false);
+	TestEqual(TEXT("Mapping fixes"), FConfigLint::Lint(mapping, output).GetFixCount(), 0);
+	TestEqual(TEXT("Mapping lines kept"), CountLines(output), 4);
+
+	FString plain = TEXT("[Paths]") LINE_TERMINATOR
+		TEXT("+Paths=A") LINE_TERMINATOR
+		TEXT("-Paths=A") LINE_TERMINATOR
+		TEXT("+Paths=A") LINE_TERMINATOR;
+	TestEqual(TEXT("Plain fixes"), FConfigLint::Lint(plain, output).GetFixCount(), 0);
+	TestEqual(TEXT("Plain lines kept"), CountLines(output), 4);
+
+	//- removes a single match, so a repeated one may still have something to remove
+	FString removeTwice = TEXT("[Paths]") LINE_TERMINATOR
+		TEXT("-Paths=A") LINE_TERMINATOR
+		TEXT("-Paths=A") LINE_TERMINATOR;
+	TestEqual(TEXT("Repeated - fixes"), FConfigLint::Lint(removeTwice, output).GetFixCount(), 0);
+
+	FString cleared = TEXT("[Paths]") LINE_TERMINATOR
+		TEXT("+Paths=A") LINE_TERMINATOR
+		TEXT("!Paths=ClearArray") LINE_TERMINATOR
+		TEXT("+Paths=A") LINE_TERMINATOR;
+	TestEqual(TEXT("Add after clearing fixes"), FConfigLint::Lint(cleared, output).GetFixCount(), 0);
+
+	//with nothing in between a repeat still goes
+	FString repeated = FString(InputSection)
+		+ MakeActionLine(TEXT("+"), TEXT("Jump"), TEXT("SpaceBar"), false)
+		+ MakeActionLine(TEXT("+"), TEXT("Jump"), TEXT("SpaceBar"), false)
+		+ TEXT("[Paths]") LINE_TERMINATOR
+		+ TEXT("+Paths=A") LINE_TERMINATOR
+		+ TEXT("+Paths=A") LINE_TERMINATOR;
+	FConfigLintResult result = FConfigLint::Lint(repeated, output);
+	TestEqual(TEXT("Repeated mapping removed"), result.DuplicateMappings, 1);
+	TestEqual(TEXT("Repeated line removed"), result.DuplicateKeys, 1);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FConfigLintMappingIdentityTest, "ExtraConfig.ConfigLint.MappingIdentity", EAutomationTestFlags::ATF_Editor | EAutomationTestFlags::ATF_Game)
+
+bool FConfigLintMappingIdentityTest::RunTest(const FString& Parameters)
+{
+	//two lines are duplicates exactly when the mappings they load into are equal to the engine
+	struct FAxisPair
+	{
+		const TCHAR* NameA;
+		const TCHAR* KeyA;
+		const TCHAR* ScaleA;
+		const TCHAR* NameB;
+		const TCHAR* KeyB;
+		const TCHAR* ScaleB;
+	};
+
+	const FAxisPair axisPairs[] =
+	{
+		{ TEXT("MoveForward"), TEXT("W"), TEXT("1.0"), TEXT("MoveForward"), TEXT("W"), TEXT("1") },
+		{ TEXT("MoveForward"), TEXT("W"), TEXT("1.0"), TEXT("MoveForward"), TEXT("W"), TEXT("1.0000001") },
+		{ TEXT("MoveForward"), TEXT("W"), TEXT("0.0"), TEXT("MoveForward"), TEXT("W"), TEXT("-0.0") },
+		{ TEXT("MoveForward"), TEXT("W"), TEXT("1.0"), TEXT("moveforward"), TEXT("w"), TEXT("1.0") },
+		{ TEXT("MoveForward"), TEXT("W"), TEXT("1.0"), TEXT("MoveForward"), TEXT("S"), TEXT("1.0") },
+	};
+
+	FString output;
+
+	for (const FAxisPair& pair : axisPairs)
+	{
+		FInputAxisKeyMapping a(FName(pair.NameA), FKey(FName(pair.KeyA)), FCString::Atof(pair.ScaleA));
+		FInputAxisKeyMapping b(FName(pair.NameB), FKey(FName(pair.KeyB)), FCString::Atof(pair.ScaleB));
+
+		FString text = FString(InputSection) + MakeAxisLine(pair.NameA, pair.KeyA, pair.ScaleA) + MakeAxisLine(pair.NameB, pair.KeyB, pair.ScaleB);
+		int32 duplicates = FConfigLint::Lint(text, output).DuplicateMappings;
+
+		FString what = FString::Printf(TEXT("%s %s %s against %s %s %s"), pair.NameA, pair.KeyA, pair.ScaleA, pair.NameB, pair.KeyB, pair.ScaleB);
+		TestEqual(what, duplicates, a == b ? 1 : 0);
+	}
+
+	//the float compare is exact, not to the six places %f prints
+	TestFalse(TEXT("Scales one ulp apart differ"), FInputAxisKeyMapping(TEXT("A"), EKeys::W, 1.f) == FInputAxisKeyMapping(TEXT("A"), EKeys::W, FCString::Atof(TEXT("1.0000001"))));
+
+	struct FActionPair
+	{
+		const TCHAR* KeyA;
+		bool ShiftA;
+		const TCHAR* KeyB;
+		bool ShiftB;
+	};
+
+	const FActionPair actionPairs[] =
+	{
+		{ TEXT("SpaceBar"), false, TEXT("SpaceBar"), false },
+		{ TEXT("SpaceBar"), false, TEXT("spacebar"), false },
+		{ TEXT("SpaceBar"), false, TEXT("SpaceBar"), true },
+	};
+
+	for (const FActionPair& pair : actionPairs)
+	{
+		FInputActionKeyMapping a(TEXT("Jump"), FKey(FName(pair.KeyA)), pair.ShiftA);
+		FInputActionKeyMapping b(TEXT("Jump"), FKey(FName(pair.KeyB)), pair.ShiftB);
+
+		FString text = FString(InputSection)
+			+ MakeActionLine(TEXT("+"), TEXT("Jump"), pair.KeyA, pair.ShiftA)
+			+ MakeActionLine(TEXT("+"), TEXT("Jump"), pair.KeyB, pair.ShiftB);
+		int32 duplicates = FConfigLint::Lint(text, output).DuplicateMappings;
+
+		FString what = FString::Printf(TEXT("%s shift %d against %s shift %d"), pair.KeyA, pair.ShiftA, pair.KeyB, pair.ShiftB);
+		TestEqual(what, duplicates, a == b ? 1 : 0);
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FConfigLintAxisConfigClampTest, "ExtraConfig.ConfigLint.AxisConfigClamp", EAutomationTestFlags::ATF_Editor | EAutomationTestFlags::ATF_Game)
+
+bool FConfigLintAxisConfigClampTest::RunTest(const FString& Parameters)
+{
+	FString text = FString(InputSection)
+		+ TEXT("+AxisConfig=(AxisKeyName=\"Gamepad_LeftX\",AxisProperties=(DeadZone=1.5,Sensitivity=1.0,Exponent=0.0,bInvert=False))") LINE_TERMINATOR;
+
+	FString output;
+	TestEqual(TEXT("Clamped entries"), FConfigLint::Lint(text, output).ClampedValues, 1);
+
+	//the lint and the plugin's own edits keep the same range
+	FInputAxisProperties expected;
+	expected.DeadZone = 1.5f;
+	expected.Exponent = 0.f;
+	FAnalogResponseCurve::ClampProperties(expected);
+
+	TestTrue(TEXT("Dead zone clamped like the plugin"), output.Contains(FString::Printf(TEXT("DeadZone=%f"), expected.DeadZone)));
+	TestTrue(TEXT("Exponent reset like the plugin"), output.Contains(FString::Printf(TEXT("Exponent=%f"), expected.Exponent)));
+
+	//a valid entry is left as written
+	FString valid = FString(InputSection)
+		+ TEXT("+AxisConfig=(AxisKeyName=\"Gamepad_LeftX\",AxisProperties=(DeadZone=0.25,Sensitivity=1.0,Exponent=2.0,bInvert=False))") LINE_TERMINATOR;
+	TestEqual(TEXT("Valid entry fixes"), FConfigLint::Lint(valid, output).GetFixCount(), 0);
+
+	return true;
+}
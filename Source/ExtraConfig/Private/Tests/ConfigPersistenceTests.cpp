@@ -0,0 +1,34 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ExtraConfigPrivatePCH.h"
+#include "ConfigPersistence.h"
+#include "AutomationTest.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FConfigPersistenceFullWriteTest, "ExtraConfig.ConfigPersistence.FullWrite", EAutomationTestFlags::ATF_Editor | EAutomationTestFlags::ATF_Game)
+
+bool FConfigPersistenceFullWriteTest::RunTest(const FString& Parameters)
+{
+	//a file with no delta defaults goes through the full FConfigFile::Write path
+	FString filename = FPaths::ConvertRelativePathToFull(FPaths::AutomationTransientDir() / TEXT("ExtraConfigPersistenceTest.ini"));
+	const TCHAR* section = TEXT("ExtraConfigTest");
+
+	FFileHelper::SaveStringToFile(TEXT("[ExtraConfigTest]") LINE_TERMINATOR TEXT("Value=Old") LINE_TERMINATOR, *filename);
+
+	GConfig->SetString(section, TEXT("Value"), TEXT("New"), filename);
+	FConfigFile* file = GConfig->Find(filename, false);
+	TestTrue(TEXT("File is dirty before the write"), file && file->Dirty);
+
+	FConfigPersistence::QueueWrite(filename);
+	FConfigPersistence::FlushPendingWrites();
+
+	FString written;
+	FFileHelper::LoadFileToString(written, *filename);
+	TestTrue(TEXT("New value on disk"), written.Contains(TEXT("Value=New")));
+	TestFalse(TEXT("Old value replaced"), written.Contains(TEXT("Value=Old")));
+	TestFalse(TEXT("Temp file moved into place"), IFileManager::Get().FileSize(*(filename + TEXT(".tmp"))) >= 0);
+
+	GConfig->Remove(filename);
+	IFileManager::Get().Delete(*filename);
+
+	return true;
+}
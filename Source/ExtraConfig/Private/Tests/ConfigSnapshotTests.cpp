@@ -0,0 +1,184 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ExtraConfigPrivatePCH.h"
+#include "ConfigSnapshot.h"
+#include "InputConfig.h"
+#include "ConfigTestBackend.h"
+#include "AutomationTest.h"
+
+//The settings the stress commits always set to one shared value
+static const EGraphicsSetting LockstepSettings[] =
+{
+	EGraphicsSetting::Shadows,
+	EGraphicsSetting::SSAO,
+	EGraphicsSetting::Reflections,
+	EGraphicsSetting::MotionBlur,
+	EGraphicsSetting::LensFlare,
+};
+
+//Hammers Acquire and checks every snapshot it sees is internally consistent
+class FSnapshotReader : public FRunnable
+{
+public:
+
+	FSnapshotReader() : Acquires(0), Inconsistent(0), OutOfOrder(0) {}
+
+	virtual uint32 Run() override
+	{
+		int32 lastGeneration = 0;
+
+		while (StopRequested.GetValue() == 0)
+		{
+			FConfigSnapshotRef snapshot = FConfigSnapshot::Acquire();
+			if (!snapshot.IsValid())
+			{
+				continue;
+			}
+
+			const FGraphicsSettings& graphics = snapshot->Graphics;
+			if (graphics.SSAO != graphics.Shadows || graphics.Reflections != graphics.Shadows
+				|| graphics.MotionBlur != graphics.Shadows || graphics.LensFlare != graphics.Shadows)
+			{
+				Inconsistent++;
+			}
+
+			if (snapshot->Generation < lastGeneration)
+			{
+				OutOfOrder++;
+			}
+			lastGeneration = snapshot->Generation;
+
+			Acquires++;
+		}
+
+		return 0;
+	}
+
+	virtual void Stop() override
+	{
+		StopRequested.Increment();
+	}
+
+	FThreadSafeCounter StopRequested;
+	int64 Acquires;
+	int32 Inconsistent;
+	int32 OutOfOrder;
+};
+
+static void CommitLockstep(int32 value)
+{
+	UGraphicsConfig::BeginGraphicsChanges();
+	for (EGraphicsSetting setting : LockstepSettings)
+	{
+		UGraphicsConfig::SetGraphicsSetting(setting, value);
+	}
+	UGraphicsConfig::CommitGraphicsChanges();
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FConfigSnapshotStressTest, "ExtraConfig.ConfigSnapshot.Stress", EAutomationTestFlags::ATF_Editor | EAutomationTestFlags::ATF_Game)
+
+bool FConfigSnapshotStressTest::RunTest(const FString& Parameters)
+{
+	const int32 ReaderCount = FMath::Clamp(FPlatformMisc::NumberOfCores() - 1, 2, 8);
+	const double Seconds = 1.0;
+
+	int32 commits = 0;
+	double slowestCommit = 0.0;
+	int64 acquires = 0;
+	int32 inconsistent = 0;
+	int32 outOfOrder = 0;
+
+	{
+		FScopedMemoryConfigBackend backend;
+
+		CommitLockstep(0);
+
+		TArray<FSnapshotReader*> readers;
+		TArray<FRunnableThread*> threads;
+		for (int32 i = 0; i < ReaderCount; i++)
+		{
+			FSnapshotReader* reader = new FSnapshotReader();
+			readers.Add(reader);
+			threads.Add(FRunnableThread::Create(reader, *FString::Printf(TEXT("ExtraConfigSnapshotReader%d"), i)));
+		}
+
+		//real commits through UGraphicsConfig, each publishing a snapshot
+		double start = FPlatformTime::Seconds();
+		while (FPlatformTime::Seconds() - start < Seconds)
+		{
+			double commitStart = FPlatformTime::Seconds();
+			CommitLockstep(commits % 4);
+			slowestCommit = FMath::Max(slowestCommit, FPlatformTime::Seconds() - commitStart);
+			commits++;
+		}
+
+		for (int32 i = 0; i < ReaderCount; i++)
+		{
+			readers[i]->Stop();
+			threads[i]->WaitForCompletion();
+			delete threads[i];
+
+			acquires += readers[i]->Acquires;
+			inconsistent += readers[i]->Inconsistent;
+			outOfOrder += readers[i]->OutOfOrder;
+			delete readers[i];
+		}
+	}
+
+	AddLogItem(FString::Printf(TEXT("%d readers: %d commits, %.1f M acquires/s, slowest commit %.3f ms"),
+		ReaderCount, commits, acquires / Seconds / 1e6, slowestCommit * 1000.0));
+
+	TestTrue(TEXT("Commits published"), commits > 0);
+	TestTrue(TEXT("Readers acquired"), acquires > 0);
+	TestEqual(TEXT("Inconsistent snapshots"), inconsistent, 0);
+	TestEqual(TEXT("Snapshots seen out of order"), outOfOrder, 0);
+
+	//with the readers gone the last publish reclaims everything it retired
+	TestEqual(TEXT("Live snapshots"), FConfigSnapshot::GetLiveCount(), 1);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FConfigSnapshotPublishOnCommitTest, "ExtraConfig.ConfigSnapshot.PublishOnCommit", EAutomationTestFlags::ATF_Editor | EAutomationTestFlags::ATF_Game)
+
+bool FConfigSnapshotPublishOnCommitTest::RunTest(const FString& Parameters)
+{
+	{
+		FScopedMemoryConfigBackend backend;
+
+		CommitLockstep(1);
+		int32 generation = FConfigSnapshot::Acquire()->Generation;
+
+		UGraphicsConfig::BeginGraphicsChanges();
+		UGraphicsConfig::SetGraphicsSetting(EGraphicsSetting::Shadows, 2);
+		TestEqual(TEXT("Nothing published inside a batch"), FConfigSnapshot::Acquire()->Generation, generation);
+
+		UGraphicsConfig::CommitGraphicsChanges();
+		FConfigSnapshotRef committed = FConfigSnapshot::Acquire();
+		TestTrue(TEXT("Published by the commit"), committed->Generation > generation);
+		TestEqual(TEXT("Committed value"), (int32)committed->Graphics.Shadows, 2);
+
+		//outside a batch every set is its own commit
+		UGraphicsConfig::SetGraphicsSetting(EGraphicsSetting::SSAO, 3);
+		TestEqual(TEXT("Unbatched set published"), (int32)FConfigSnapshot::Acquire()->Graphics.SSAO, 3);
+	}
+
+	static const FName ActionName(TEXT("ExtraConfigTest_SnapshotAction"));
+	auto HasTestAction = []()
+	{
+		FConfigSnapshotRef snapshot = FConfigSnapshot::Acquire();
+		return snapshot->ActionMappings.ContainsByPredicate([](const FInputActionKeyMapping& mapping) { return mapping.ActionName == ActionName; });
+	};
+
+	UInputConfig::AddActionMapping(ActionName, EKeys::F11, false, false, false, false);
+	TestFalse(TEXT("Input edits are not published before SaveChanges"), HasTestAction());
+
+	UInputConfig::SaveChanges();
+	TestTrue(TEXT("SaveChanges publishes"), HasTestAction());
+
+	UInputConfig::RemoveActionMapping(ActionName, EKeys::F11, false, false, false, false);
+	UInputConfig::SaveChanges();
+	TestFalse(TEXT("Removal published"), HasTestAction());
+
+	return true;
+}
@@ -0,0 +1,49 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "ConfigBackend.h"
+#include "InputConfig.h"
+#include "ConfigSnapshot.h"
+#include "GraphicsSettingDescriptors.h"
+
+/**
+ * Routes config through an FMemoryConfigBackend for the life of the scope, seeded with the current
+ * values, so tests can commit freely without touching the ini files, the renderer or the players.
+ * Input edits and saves go to the backend's copy of the input settings, which is dropped with it,
+ * so the real mapping arrays and Input.ini are never modified.
+ */
+class FScopedMemoryConfigBackend
+{
+public:
+
+	FScopedMemoryConfigBackend() : Original(UGraphicsConfig::GetGraphicsSettings())
+	{
+		for (const FGraphicsSettingDescriptor& desc : GraphicsSettingDescriptors)
+		{
+			Memory.SetString(TEXT("ConsoleVariables"), desc.CVarName, FString::FromInt(desc.Get(Original)), GEngineIni);
+			Memory.CVars.Add(desc.CVarName, desc.Get(Original));
+		}
+
+		IConfigBackend::Set(&Memory);
+		UGraphicsConfig::InvalidateGraphicsSettings();
+	}
+
+	~FScopedMemoryConfigBackend()
+	{
+		//setting the seeded values back leaves nothing queued for the next map load or restart
+		UGraphicsConfig::ApplyGraphicsSettings(Original);
+
+		//unsaved input edits would otherwise be pushed by the next real SaveChanges
+		UInputConfig::DiscardChanges();
+
+		IConfigBackend::Set(nullptr);
+		UGraphicsConfig::InvalidateGraphicsSettings();
+
+		//readers shouldn't keep seeing the test's values
+		FConfigSnapshot::PublishCurrent();
+	}
+
+	FGraphicsSettings Original;
+	FMemoryConfigBackend Memory;
+};
@@ -0,0 +1,112 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ExtraConfigPrivatePCH.h"
+#include "DisplayModeIndex.h"
+#include "GraphicsConfig.h"
+#include "AutomationTest.h"
+
+//What the injected provider reports, and how often the index asked for it
+static FScreenResolutionArray TestResolutions;
+static int32 TestProviderCalls = 0;
+
+static void AddTestResolution(uint32 width, uint32 height, uint32 refreshRate)
+{
+	FScreenResolutionRHI res;
+	res.Width = width;
+	res.Height = height;
+	res.RefreshRate = refreshRate;
+	TestResolutions.Add(res);
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDisplayModeIndexTest, "ExtraConfig.DisplayModeIndex.Modes", EAutomationTestFlags::ATF_Editor | EAutomationTestFlags::ATF_Game)
+
+bool FDisplayModeIndexTest::RunTest(const FString& Parameters)
+{
+	FDisplayModeIndex& index = FDisplayModeIndex::Get();
+
+	//unsorted, the way adapters report them, with one mode listed twice
+	TestResolutions.Reset();
+	AddTestResolution(2560, 1440, 144);
+	AddTestResolution(1920, 1080, 60);
+	AddTestResolution(3840, 2160, 60);
+	AddTestResolution(2560, 1440, 60);
+	AddTestResolution(1280, 1024, 60);
+	AddTestResolution(1920, 1080, 144);
+	AddTestResolution(1366, 768, 60);
+	AddTestResolution(2560, 1440, 165);
+	AddTestResolution(1280, 720, 60);
+	AddTestResolution(1920, 1080, 60);
+	TestProviderCalls = 0;
+
+	index.SetProvider([](FScreenResolutionArray& resolutions)
+	{
+		TestProviderCalls++;
+		resolutions = TestResolutions;
+		return true;
+	});
+
+	//modes that differ only by refresh rate collapse into one, ordered by width then height
+	const TArray<FDisplayMode>& modes = index.GetModes();
+	TestEqual(TEXT("Mode count"), modes.Num(), 6);
+
+	const int32 expected[][2] = { { 1280, 720 }, { 1280, 1024 }, { 1366, 768 }, { 1920, 1080 }, { 2560, 1440 }, { 3840, 2160 } };
+	for (int32 i = 0; i < FMath::Min<int32>(modes.Num(), ARRAY_COUNT(expected)); i++)
+	{
+		TestEqual(FString::Printf(TEXT("Mode %d width"), i), modes[i].Width, expected[i][0]);
+		TestEqual(FString::Printf(TEXT("Mode %d height"), i), modes[i].Height, expected[i][1]);
+	}
+
+	TArray<int32> rates = UGraphicsConfig::GetRefreshRates(2560, 1440);
+	TestEqual(TEXT("2560x1440 refresh rate count"), rates.Num(), 3);
+	if (rates.Num() == 3)
+	{
+		TestEqual(TEXT("2560x1440 lowest rate"), rates[0], 60);
+		TestEqual(TEXT("2560x1440 middle rate"), rates[1], 144);
+		TestEqual(TEXT("2560x1440 highest rate"), rates[2], 165);
+	}
+
+	TestEqual(TEXT("1920x1080 listed twice at 60 Hz"), UGraphicsConfig::GetRefreshRates(1920, 1080).Num(), 2);
+	TestEqual(TEXT("Unknown mode has no rates"), UGraphicsConfig::GetRefreshRates(1600, 900).Num(), 0);
+
+	//1366x768 shares the 16:9 bucket, 1280x1024 doesn't
+	const FDisplayMode* largest = index.FindLargestAtMost(2560, 1600, 16, 9);
+	TestTrue(TEXT("16:9 inside 2560x1600"), largest && largest->Width == 2560 && largest->Height == 1440);
+
+	largest = index.FindLargestAtMost(2000, 2000, 16, 9);
+	TestTrue(TEXT("16:9 inside 2000x2000"), largest && largest->Width == 1920 && largest->Height == 1080);
+
+	largest = index.FindLargestAtMost(1900, 1000, 16, 9);
+	TestTrue(TEXT("16:9 inside 1900x1000"), largest && largest->Width == 1366 && largest->Height == 768);
+
+	TestTrue(TEXT("16:9 inside 1000x1000"), index.FindLargestAtMost(1000, 1000, 16, 9) == nullptr);
+	TestTrue(TEXT("No 21:9 modes"), index.FindLargestAtMost(3840, 2160, 21, 9) == nullptr);
+
+	largest = index.FindLargestAtMost(3840, 2160, 5, 4);
+	TestTrue(TEXT("5:4 bucket"), largest && largest->Width == 1280 && largest->Height == 1024);
+
+	TestEqual(TEXT("Provider calls while the index is built"), TestProviderCalls, 1);
+
+	//a display change bumps the generation; the provider isn't asked again until the next query
+	TestResolutions.Reset();
+	AddTestResolution(1920, 1080, 60);
+	index.Invalidate();
+	TestEqual(TEXT("Provider calls after a display change"), TestProviderCalls, 1);
+
+	TestEqual(TEXT("Mode count after a display change"), index.GetModes().Num(), 1);
+	TestEqual(TEXT("Provider calls after the rebuild"), TestProviderCalls, 2);
+	TestTrue(TEXT("Removed mode is gone"), index.Find(2560, 1440) == nullptr);
+	TestTrue(TEXT("16:9 after a display change"), index.FindLargestAtMost(2560, 1600, 16, 9) == index.Find(1920, 1080));
+
+	//a provider that can't enumerate leaves the index empty rather than stale
+	index.SetProvider([](FScreenResolutionArray& resolutions)
+	{
+		TestProviderCalls++;
+		return false;
+	});
+	TestEqual(TEXT("Modes when enumeration fails"), index.GetModes().Num(), 0);
+
+	index.SetProvider(nullptr);
+	TestResolutions.Reset();
+
+	return true;
+}
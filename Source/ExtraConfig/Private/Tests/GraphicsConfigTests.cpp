@@ -0,0 +1,148 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ExtraConfigPrivatePCH.h"
+#include "GraphicsConfig.h"
+#include "ConfigTestBackend.h"
+#include "AutomationTest.h"
+
+//What the backend holds for a setting's console variable in the engine ini
+static int32 GetStoredValue(FMemoryConfigBackend& memory, const FGraphicsSettingDescriptor& desc)
+{
+	FString text;
+	return memory.GetString(TEXT("ConsoleVariables"), desc.CVarName, text, GEngineIni) ? FCString::Atoi(*text) : INDEX_NONE;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGraphicsConfigRoundTripTest, "ExtraConfig.GraphicsConfig.RoundTrip", EAutomationTestFlags::ATF_Editor | EAutomationTestFlags::ATF_Game)
+
+bool FGraphicsConfigRoundTripTest::RunTest(const FString& Parameters)
+{
+	FScopedMemoryConfigBackend backend;
+
+	//every value of every field, one past each end included, reads back clamped to the range
+	for (const FGraphicsSettingDescriptor& desc : GraphicsSettingDescriptors)
+	{
+		for (int32 value = desc.MinValue - 1; value <= desc.MaxValue + 1; value++)
+		{
+			UGraphicsConfig::SetGraphicsSetting(desc.Setting, value);
+
+			int32 expected = desc.Clamp(value);
+			FString what = FString::Printf(TEXT("%s set to %d"), desc.CVarName, value);
+
+			TestEqual(what + TEXT(", single read"), UGraphicsConfig::GetGraphicsSetting(desc.Setting), expected);
+			TestEqual(what + TEXT(", cached struct"), desc.Get(UGraphicsConfig::GetGraphicsSettings()), expected);
+			TestEqual(what + TEXT(", uncached struct"), desc.Get(UGraphicsConfig::ReadGraphicsSettingsFromConfig()), expected);
+			TestEqual(what + TEXT(", stored"), GetStoredValue(backend.Memory, desc), expected);
+
+			if (desc.Apply == EGraphicsApply::Instant)
+			{
+				const int32* live = backend.Memory.CVars.Find(desc.CVarName);
+				TestTrue(what + TEXT(", applied live"), live && *live == expected);
+			}
+		}
+	}
+
+	//a whole struct in one commit, with every field away from its neighbour's value
+	FGraphicsSettings settings;
+	for (const FGraphicsSettingDescriptor& desc : GraphicsSettingDescriptors)
+	{
+		int32 range = desc.MaxValue - desc.MinValue + 1;
+		desc.Set(settings, desc.MinValue + ((int32)desc.Setting + 1) % range);
+	}
+
+	UGraphicsConfig::ApplyGraphicsSettings(settings);
+
+	TestEqual(TEXT("Cached fields differing after a commit"), UGraphicsConfig::DiffGraphicsSettings(UGraphicsConfig::GetGraphicsSettings(), settings), 0);
+	TestEqual(TEXT("Stored fields differing after a commit"), UGraphicsConfig::DiffGraphicsSettings(UGraphicsConfig::ReadGraphicsSettingsFromConfig(), settings), 0);
+
+	//committing the same values again has nothing to do
+	FGraphicsSettings before = UGraphicsConfig::GetGraphicsSettings();
+	int32 writes = backend.Memory.Writes;
+	int32 cvarSets = backend.Memory.CVarSets;
+	TestEqual(TEXT("Files flushed by a repeated commit"), UGraphicsConfig::ApplyGraphicsSettings(settings), 0);
+	TestEqual(TEXT("Fields changed by a repeated commit"), UGraphicsConfig::DiffGraphicsSettings(UGraphicsConfig::GetGraphicsSettings(), before), 0);
+	TestEqual(TEXT("Writes queued by a repeated commit"), backend.Memory.Writes, writes);
+	TestEqual(TEXT("Cvars set by a repeated commit"), backend.Memory.CVarSets, cvarSets);
+
+	return true;
+}
+
+//The Blueprint setters, each expected to write its own field and nothing else
+struct FNamedGraphicsSetter
+{
+	EGraphicsSetting Setting;
+	void (*Set)(int32 value);
+};
+
+static const FNamedGraphicsSetter NamedGraphicsSetters[] =
+{
+	{ EGraphicsSetting::VSync,			[](int32 value) { UGraphicsConfig::ToggleVSync(value != 0); } },
+	{ EGraphicsSetting::Anisotropic,	[](int32 value) { UGraphicsConfig::SetAnisotropic(value); } },
+	{ EGraphicsSetting::Antialiasing,	[](int32 value) { UGraphicsConfig::SetAntialiasing((EQuality)value); } },
+	{ EGraphicsSetting::Shadows,		[](int32 value) { UGraphicsConfig::SetShadowQuality((EQuality)value); } },
+	{ EGraphicsSetting::SSAO,			[](int32 value) { UGraphicsConfig::SetAmbientOcclusion((EQuality)value); } },
+	{ EGraphicsSetting::Reflections,	[](int32 value) { UGraphicsConfig::SetReflections((EQuality)value); } },
+	{ EGraphicsSetting::MotionBlur,		[](int32 value) { UGraphicsConfig::SetMotionBlur((EQuality)value); } },
+	{ EGraphicsSetting::LensFlare,		[](int32 value) { UGraphicsConfig::SetLensFlare((EQuality)value); } },
+	{ EGraphicsSetting::Bloom,			[](int32 value) { UGraphicsConfig::SetBloom((EQuality)value); } },
+	{ EGraphicsSetting::SimpleLighting,	[](int32 value) { UGraphicsConfig::ToggleSimpleLighting(value != 0); } },
+	{ EGraphicsSetting::ViewDistance,	[](int32 value) { UGraphicsConfig::SetViewDistanceQuality((EQuality)value); } },
+	{ EGraphicsSetting::Textures,		[](int32 value) { UGraphicsConfig::SetTextureQuality((EQuality)value); } },
+	{ EGraphicsSetting::Effects,		[](int32 value) { UGraphicsConfig::SetEffectsQuality((EQuality)value); } },
+	{ EGraphicsSetting::PostProcess,	[](int32 value) { UGraphicsConfig::SetPostProcessQuality((EQuality)value); } },
+	{ EGraphicsSetting::Foliage,		[](int32 value) { UGraphicsConfig::SetFoliageQuality((EQuality)value); } },
+};
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGraphicsConfigNamedSettersTest, "ExtraConfig.GraphicsConfig.NamedSetters", EAutomationTestFlags::ATF_Editor | EAutomationTestFlags::ATF_Game)
+
+bool FGraphicsConfigNamedSettersTest::RunTest(const FString& Parameters)
+{
+	TestEqual(TEXT("A setter per field"), (int32)ARRAY_COUNT(NamedGraphicsSetters), (int32)EGraphicsSetting::MAX);
+
+	FScopedMemoryConfigBackend backend;
+
+	for (const FNamedGraphicsSetter& setter : NamedGraphicsSetters)
+	{
+		const FGraphicsSettingDescriptor& desc = GetGraphicsSettingDescriptor(setter.Setting);
+
+		for (int32 value = desc.MinValue; value <= desc.MaxValue; value++)
+		{
+			FGraphicsSettings before = UGraphicsConfig::GetGraphicsSettings();
+			setter.Set(value);
+			FGraphicsSettings after = UGraphicsConfig::GetGraphicsSettings();
+
+			FString what = FString::Printf(TEXT("%s set to %d"), desc.CVarName, value);
+			TestEqual(what, desc.Get(after), value);
+			TestEqual(what + TEXT(", stored"), GetStoredValue(backend.Memory, desc), value);
+
+			int32 others = UGraphicsConfig::DiffGraphicsSettings(before, after) & ~(1 << (int32)setter.Setting);
+			TestEqual(what + TEXT(", other fields changed"), others, 0);
+		}
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGraphicsConfigDetectionCacheTest, "ExtraConfig.GraphicsConfig.DetectionCache", EAutomationTestFlags::ATF_Editor | EAutomationTestFlags::ATF_Game)
+
+bool FGraphicsConfigDetectionCacheTest::RunTest(const FString& Parameters)
+{
+	//the results are cached through the backend, so the real user settings stay untouched
+	FScopedMemoryConfigBackend backend;
+
+	FRecommendedSettings detected = UGraphicsConfig::DetectRecommendedPreset(true);
+
+	FString fingerprint;
+	TestTrue(TEXT("Fingerprint cached in the backend"),
+		backend.Memory.GetString(TEXT("ExtraConfig.HardwareDetection"), TEXT("Fingerprint"), fingerprint, GGameUserSettingsIni));
+
+	FRecommendedSettings cached = UGraphicsConfig::DetectRecommendedPreset(false);
+	TestEqual(TEXT("Cached preset"), (int32)cached.Preset, (int32)detected.Preset);
+	TestEqual(TEXT("Cached fields differing"), UGraphicsConfig::DiffGraphicsSettings(cached.Settings, detected.Settings), 0);
+
+	//an edited cache is what the next call reads
+	int32 edited = detected.Preset == EQuality::Low ? (int32)EQuality::High : (int32)EQuality::Low;
+	backend.Memory.SetString(TEXT("ExtraConfig.HardwareDetection"), TEXT("Preset"), FString::FromInt(edited), GGameUserSettingsIni);
+	TestEqual(TEXT("Preset read from the backend"), (int32)UGraphicsConfig::DetectRecommendedPreset(false).Preset, edited);
+
+	return true;
+}
@@ -0,0 +1,100 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ExtraConfigPrivatePCH.h"
+#include "HardwareDetection.h"
+#include "AutomationTest.h"
+
+//A machine that reaches Ultra on every component, for tests that lower one of them
+static FHardwareSurvey MakeUltraSurvey()
+{
+	FHardwareSurvey survey;
+	survey.CPUScore = 200.f;
+	survey.Cores = 8;
+	survey.LogicalCores = 16;
+	survey.TotalMemoryMB = 32 * 1024;
+	survey.AvailableMemoryMB = 16 * 1024;
+	survey.GPUVendorId = 0x10DE;
+	return survey;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHardwareDetectionTiersTest, "ExtraConfig.HardwareDetection.Tiers", EAutomationTestFlags::ATF_Editor | EAutomationTestFlags::ATF_Game)
+
+bool FHardwareDetectionTiersTest::RunTest(const FString& Parameters)
+{
+	TestEqual(TEXT("CPU 59"), (int32)FHardwareDetection::GetCPUTier(59.f), (int32)EQuality::Low);
+	TestEqual(TEXT("CPU 60"), (int32)FHardwareDetection::GetCPUTier(60.f), (int32)EQuality::Medium);
+	TestEqual(TEXT("CPU 100"), (int32)FHardwareDetection::GetCPUTier(100.f), (int32)EQuality::High);
+	TestEqual(TEXT("CPU 160"), (int32)FHardwareDetection::GetCPUTier(160.f), (int32)EQuality::Ultra);
+
+	//installed memory is rounded to the nearest GB, so 5.6 GB counts as 6
+	TestEqual(TEXT("Memory 4 GB"), (int32)FHardwareDetection::GetMemoryTier(4 * 1024), (int32)EQuality::Low);
+	TestEqual(TEXT("Memory 5.6 GB"), (int32)FHardwareDetection::GetMemoryTier(5734), (int32)EQuality::Medium);
+	TestEqual(TEXT("Memory 8 GB"), (int32)FHardwareDetection::GetMemoryTier(8 * 1024), (int32)EQuality::Medium);
+	TestEqual(TEXT("Memory 12 GB"), (int32)FHardwareDetection::GetMemoryTier(12 * 1024), (int32)EQuality::High);
+	TestEqual(TEXT("Memory 16 GB"), (int32)FHardwareDetection::GetMemoryTier(16 * 1024), (int32)EQuality::Ultra);
+
+	TestEqual(TEXT("2 cores"), (int32)FHardwareDetection::GetCoreTier(2), (int32)EQuality::Low);
+	TestEqual(TEXT("4 cores"), (int32)FHardwareDetection::GetCoreTier(4), (int32)EQuality::High);
+	TestEqual(TEXT("6 cores"), (int32)FHardwareDetection::GetCoreTier(6), (int32)EQuality::Ultra);
+
+	TestEqual(TEXT("Intel GPU"), (int32)FHardwareDetection::GetGPUTier(0x8086), (int32)EQuality::Low);
+	TestEqual(TEXT("No RHI"), (int32)FHardwareDetection::GetGPUTier(0), (int32)EQuality::Ultra);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHardwareDetectionRecommendTest, "ExtraConfig.HardwareDetection.Recommend", EAutomationTestFlags::ATF_Editor | EAutomationTestFlags::ATF_Game)
+
+bool FHardwareDetectionRecommendTest::RunTest(const FString& Parameters)
+{
+	FGraphicsSettings settings;
+
+	FHardwareSurvey ultra = MakeUltraSurvey();
+	TestEqual(TEXT("Ultra machine"), (int32)FHardwareDetection::Recommend(ultra, settings), (int32)EQuality::Ultra);
+	int32 ultraTextures = (int32)FHardwareDetection::MakePresetSettings(EQuality::Ultra).Textures;
+	TestEqual(TEXT("Ultra machine keeps the preset textures"), (int32)settings.Textures, ultraTextures);
+
+	//memory is the weakest component: the preset follows it and textures go one lower still
+	FHardwareSurvey lowMemory = MakeUltraSurvey();
+	lowMemory.TotalMemoryMB = 8 * 1024;
+	TestEqual(TEXT("Memory bound preset"), (int32)FHardwareDetection::Recommend(lowMemory, settings), (int32)EQuality::Medium);
+	TestEqual(TEXT("Memory bound textures"), (int32)settings.Textures, (int32)EQuality::Low);
+
+	//a slow CPU lowers the preset but not the textures
+	FHardwareSurvey slowCPU = MakeUltraSurvey();
+	slowCPU.CPUScore = 80.f;
+	TestEqual(TEXT("CPU bound preset"), (int32)FHardwareDetection::Recommend(slowCPU, settings), (int32)EQuality::Medium);
+	TestEqual(TEXT("CPU bound textures"), (int32)settings.Textures, (int32)EQuality::Medium);
+	TestTrue(TEXT("CPU bound view distance lowered"), (int32)settings.ViewDistance < (int32)EQuality::Medium);
+
+	FHardwareSurvey lowAvailable = MakeUltraSurvey();
+	lowAvailable.AvailableMemoryMB = 1024;
+	FHardwareDetection::Recommend(lowAvailable, settings);
+	TestEqual(TEXT("Low available memory textures"), (int32)settings.Textures, ultraTextures - 1);
+
+	FHardwareSurvey integrated = MakeUltraSurvey();
+	integrated.GPUVendorId = 0x8086;
+	TestEqual(TEXT("Integrated GPU preset"), (int32)FHardwareDetection::Recommend(integrated, settings), (int32)EQuality::Low);
+	TestEqual(TEXT("Integrated GPU SSAO"), (int32)settings.SSAO, (int32)EQuality::Off);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHardwareDetectionSurveyTest, "ExtraConfig.HardwareDetection.Survey", EAutomationTestFlags::ATF_Editor | EAutomationTestFlags::ATF_Game)
+
+bool FHardwareDetectionSurveyTest::RunTest(const FString& Parameters)
+{
+	//the CPU and memory part has to work without an RHI
+	FHardwareSurvey survey = FHardwareDetection::Survey();
+	TestTrue(TEXT("Cores found"), survey.Cores > 0);
+	TestTrue(TEXT("Memory found"), survey.TotalMemoryMB > 0);
+	TestTrue(TEXT("CPU score measured"), FHardwareDetection::RunCPUBenchmark() > 0.f);
+
+	TestTrue(TEXT("Fingerprint is stable"), FHardwareDetection::Fingerprint(survey) == FHardwareDetection::Fingerprint(survey));
+
+	FHardwareSurvey upgraded = survey;
+	upgraded.TotalMemoryMB += 4 * 1024;
+	TestTrue(TEXT("Fingerprint follows installed memory"), FHardwareDetection::Fingerprint(survey) != FHardwareDetection::Fingerprint(upgraded));
+
+	return true;
+}
@@ -0,0 +1,320 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ExtraConfigPrivatePCH.h"
+#include "InputConfig.h"
+#include "ConfigTestBackend.h"
+#include "AutomationTest.h"
+
+/**
+ * Forwards to the engine allocator and counts the allocations made on the game thread while
+ * installed, so other threads allocating in the background don't fail the test.
+ */
+class FCountingMalloc : public FMalloc
+{
+public:
+
+	FCountingMalloc() : Inner(nullptr), Allocations(0) {}
+
+	void Install()
+	{
+		Inner = GMalloc;
+		Allocations = 0;
+		GMalloc = this;
+	}
+
+	void Uninstall()
+	{
+		//calls already inside this proxy still forward to Inner, which stays alive
+		GMalloc = Inner;
+	}
+
+	virtual void* Malloc(SIZE_T count, uint32 alignment) override
+	{
+		if (IsInGameThread())
+		{
+			Allocations++;
+		}
+		return Inner->Malloc(count, alignment);
+	}
+
+	virtual void* Realloc(void* original, SIZE_T count, uint32 alignment) override
+	{
+		if (IsInGameThread() && count > 0)
+		{
+			Allocations++;
+		}
+		return Inner->Realloc(original, count, alignment);
+	}
+
+	virtual void Free(void* original) override
+	{
+		Inner->Free(original);
+	}
+
+	virtual bool GetAllocationSize(void* original, SIZE_T& sizeOut) override
+	{
+		return Inner->GetAllocationSize(original, sizeOut);
+	}
+
+	virtual bool IsInternallyThreadSafe() const override
+	{
+		return Inner->IsInternallyThreadSafe();
+	}
+
+	FMalloc* Inner;
+	int32 Allocations;
+};
+
+static const FName AllocActionName(TEXT("ExtraConfigTest_AllocAction"));
+static const FName AllocAxisName(TEXT("ExtraConfigTest_AllocAxis"));
+
+static void RunHotQueries(int32 iterations, float& sink)
+{
+	for (int32 i = 0; i < iterations; i++)
+	{
+		sink += UInputConfig::ViewActionNames().Num();
+		sink += UInputConfig::ViewKeysForAction(AllocActionName).Num();
+		sink += UInputConfig::ViewAxisNames().Num();
+		sink += UInputConfig::ViewKeysForAxis(AllocAxisName).Num();
+		sink += UInputConfig::ViewAnalogKeys().Num();
+		sink += UInputConfig::IsDoubleBound(EKeys::F10, AllocActionName) ? 1.f : 0.f;
+		sink += UInputConfig::GetConfigForAnalog(EKeys::Gamepad_RightX).DeadZone;
+		sink += UInputConfig::EvaluateAnalog(EKeys::Gamepad_RightX, 0.5f);
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInputConfigQueryAllocationTest, "ExtraConfig.InputConfig.QueriesDoNotAllocate", EAutomationTestFlags::ATF_Editor | EAutomationTestFlags::ATF_Game)
+
+bool FInputConfigQueryAllocationTest::RunTest(const FString& Parameters)
+{
+	//edits and saves go to the backend's copy of the input settings, never the real ones
+	FScopedMemoryConfigBackend backend;
+
+	UInputConfig::AddActionMapping(AllocActionName, EKeys::F10, false, false, false, false);
+	UInputConfig::AddAxisMapping(AllocAxisName, EKeys::Gamepad_RightX, 1.f);
+	UInputConfig::AddAnalogConfig(EKeys::Gamepad_RightX, false, 0.2f, 1.f, 2.f);
+
+	//the first pass builds the indexes and the response curve
+	float sink = 0.f;
+	RunHotQueries(1, sink);
+
+	static FCountingMalloc CountingMalloc;
+	CountingMalloc.Install();
+	RunHotQueries(1000, sink);
+	CountingMalloc.Uninstall();
+
+	TestEqual(TEXT("Allocations across 1000 warm query rounds"), CountingMalloc.Allocations, 0);
+	TestTrue(TEXT("Queries saw the test bindings"), sink > 0.f);
+
+	return true;
+}
+
+//Keys no project binds, so the defaults can't satisfy or break the checks below
+static const FKey TestKeyA(FName(TEXT("ExtraConfigTest_KeyA")));
+static const FKey TestKeyB(FName(TEXT("ExtraConfigTest_KeyB")));
+static const FName TestActionName(TEXT("ExtraConfigTest_Action"));
+static const FName TestOtherActionName(TEXT("ExtraConfigTest_OtherAction"));
+static const FName TestAxisName(TEXT("ExtraConfigTest_Axis"));
+
+static bool HasActionMap(FName actionName, const FKey& key, bool ctrl, bool shift, bool alt, bool cmd)
+{
+	return UInputConfig::GetKeysForAction(actionName).ContainsByPredicate([&](const FActionMap& map)
+	{
+		return map.Key == key && map.Ctrl == ctrl && map.Shift == shift && map.Alt == alt && map.Cmd == cmd;
+	});
+}
+
+static bool HasAxisMap(FName axisName, const FKey& key, float scale)
+{
+	return UInputConfig::GetKeysForAxis(axisName).ContainsByPredicate([&](const FAxisMap& map)
+	{
+		return map.Key == key && map.Scale == scale;
+	});
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInputConfigActionMappingsTest, "ExtraConfig.InputConfig.ActionMappings", EAutomationTestFlags::ATF_Editor | EAutomationTestFlags::ATF_Game)
+
+bool FInputConfigActionMappingsTest::RunTest(const FString& Parameters)
+{
+	FScopedMemoryConfigBackend backend;
+
+	TestTrue(TEXT("Add"), UInputConfig::AddActionMapping(TestActionName, TestKeyA, true, false, false, false));
+	TestTrue(TEXT("Added mapping listed"), HasActionMap(TestActionName, TestKeyA, true, false, false, false));
+	TestTrue(TEXT("Added name listed"), UInputConfig::GetActionNames().Contains(TestActionName));
+
+	UInputConfig::AddActionMapping(TestActionName, TestKeyA, true, false, false, false);
+	TestEqual(TEXT("Adding a mapping twice keeps one"), UInputConfig::GetKeysForAction(TestActionName).Num(), 1);
+
+	UInputConfig::AddActionMapping(TestActionName, TestKeyB, false, false, true, false);
+	TestEqual(TEXT("Second key"), UInputConfig::GetKeysForAction(TestActionName).Num(), 2);
+
+	TestTrue(TEXT("Modify"), UInputConfig::ModifyActionMapping(TestActionName, TestKeyA, false, true, false, true));
+	TestTrue(TEXT("Modified modifiers listed"), HasActionMap(TestActionName, TestKeyA, false, true, false, true));
+	TestFalse(TEXT("Old modifiers gone"), HasActionMap(TestActionName, TestKeyA, true, false, false, false));
+	TestFalse(TEXT("Modifying an unbound key fails"), UInputConfig::ModifyActionMapping(TestOtherActionName, TestKeyA, false, false, false, false));
+
+	TestTrue(TEXT("Remove"), UInputConfig::RemoveActionMapping(TestActionName, TestKeyA, false, true, false, true));
+	TestFalse(TEXT("Removed mapping gone"), HasActionMap(TestActionName, TestKeyA, false, true, false, true));
+	TestTrue(TEXT("Other key kept"), HasActionMap(TestActionName, TestKeyB, false, false, true, false));
+
+	UInputConfig::RemoveActionMapping(TestActionName, TestKeyB, false, false, true, false);
+	TestFalse(TEXT("Name gone with its last mapping"), UInputConfig::GetActionNames().Contains(TestActionName));
+
+	//nothing was saved, so the players never saw any of it
+	UInputConfig::DiscardChanges();
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInputConfigAxisMappingsTest, "ExtraConfig.InputConfig.AxisMappings", EAutomationTestFlags::ATF_Editor | EAutomationTestFlags::ATF_Game)
+
+bool FInputConfigAxisMappingsTest::RunTest(const FString& Parameters)
+{
+	FScopedMemoryConfigBackend backend;
+
+	TestTrue(TEXT("Add"), UInputConfig::AddAxisMapping(TestAxisName, TestKeyA, -1.f));
+	TestTrue(TEXT("Added mapping listed"), HasAxisMap(TestAxisName, TestKeyA, -1.f));
+	TestTrue(TEXT("Added name listed"), UInputConfig::GetAxisNames().Contains(TestAxisName));
+
+	UInputConfig::AddAxisMapping(TestAxisName, TestKeyB, 1.f);
+	TestEqual(TEXT("Second key"), UInputConfig::GetKeysForAxis(TestAxisName).Num(), 2);
+
+	TestTrue(TEXT("Modify"), UInputConfig::ModifyAxisMapping(TestAxisName, TestKeyA, 0.5f));
+	TestTrue(TEXT("Modified scale listed"), HasAxisMap(TestAxisName, TestKeyA, 0.5f));
+	TestFalse(TEXT("Old scale gone"), HasAxisMap(TestAxisName, TestKeyA, -1.f));
+	TestFalse(TEXT("Modifying an unbound key fails"), UInputConfig::ModifyAxisMapping(TestActionName, TestKeyA, 1.f));
+
+	TestTrue(TEXT("Remove"), UInputConfig::RemoveAxisMapping(TestAxisName, TestKeyA, 0.5f));
+	TestFalse(TEXT("Removed mapping gone"), HasAxisMap(TestAxisName, TestKeyA, 0.5f));
+	TestTrue(TEXT("Other key kept"), HasAxisMap(TestAxisName, TestKeyB, 1.f));
+
+	UInputConfig::RemoveAxisMapping(TestAxisName, TestKeyB, 1.f);
+	TestFalse(TEXT("Name gone with its last mapping"), UInputConfig::GetAxisNames().Contains(TestAxisName));
+
+	UInputConfig::DiscardChanges();
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInputConfigAnalogConfigTest, "ExtraConfig.InputConfig.AnalogConfig", EAutomationTestFlags::ATF_Editor | EAutomationTestFlags::ATF_Game)
+
+bool FInputConfigAnalogConfigTest::RunTest(const FString& Parameters)
+{
+	FScopedMemoryConfigBackend backend;
+
+	TestTrue(TEXT("Add"), UInputConfig::AddAnalogConfig(TestKeyA, true, 0.25f, 2.f, 1.5f));
+	TestTrue(TEXT("Added key listed"), UInputConfig::GetAnalogKeys().Contains(TestKeyA));
+
+	FAnalogConfig added = UInputConfig::GetConfigForAnalog(TestKeyA);
+	TestTrue(TEXT("Added invert"), added.Invert);
+	TestEqual(TEXT("Added dead zone"), added.DeadZone, 0.25f);
+	TestEqual(TEXT("Added sensitivity"), added.Multiplier, 2.f);
+	TestEqual(TEXT("Added exponent"), added.Exponent, 1.5f);
+
+	//adding again edits the entry instead of making a second one
+	UInputConfig::AddAnalogConfig(TestKeyA, false, 0.1f, 1.f, 1.f);
+	int32 entries = 0;
+	for (const FKey& key : UInputConfig::GetAnalogKeys())
+	{
+		entries += key == TestKeyA ? 1 : 0;
+	}
+	TestEqual(TEXT("Entries after adding twice"), entries, 1);
+	TestEqual(TEXT("Re-added dead zone"), UInputConfig::GetConfigForAnalog(TestKeyA).DeadZone, 0.1f);
+
+	TestTrue(TEXT("Modify"), UInputConfig::ModifyAnalogConfig(TestKeyA, false, 0.3f, 3.f, 2.f));
+	FAnalogConfig modified = UInputConfig::GetConfigForAnalog(TestKeyA);
+	TestFalse(TEXT("Modified invert"), modified.Invert);
+	TestEqual(TEXT("Modified dead zone"), modified.DeadZone, 0.3f);
+	TestEqual(TEXT("Modified sensitivity"), modified.Multiplier, 3.f);
+	TestEqual(TEXT("Modified exponent"), modified.Exponent, 2.f);
+	TestFalse(TEXT("Modifying an unconfigured key fails"), UInputConfig::ModifyAnalogConfig(TestKeyB, false, 0.f, 1.f, 1.f));
+
+	//at full deflection the curve gives the sensitivity
+	TestEqual(TEXT("Evaluated at full deflection"), UInputConfig::EvaluateAnalog(TestKeyA, 1.f), 3.f, 1e-3f);
+	TestEqual(TEXT("Evaluated inside the dead zone"), UInputConfig::EvaluateAnalog(TestKeyA, 0.2f), 0.f);
+
+	TestTrue(TEXT("Remove"), UInputConfig::RemoveAnalogConfig(TestKeyA));
+	TestFalse(TEXT("Removed key gone"), UInputConfig::GetAnalogKeys().Contains(TestKeyA));
+	TestFalse(TEXT("Removing twice fails"), UInputConfig::RemoveAnalogConfig(TestKeyA));
+
+	UInputConfig::DiscardChanges();
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInputConfigConflictsTest, "ExtraConfig.InputConfig.Conflicts", EAutomationTestFlags::ATF_Editor | EAutomationTestFlags::ATF_Game)
+
+bool FInputConfigConflictsTest::RunTest(const FString& Parameters)
+{
+	FScopedMemoryConfigBackend backend;
+
+	UInputConfig::AddActionMapping(TestActionName, TestKeyA, true, false, false, false);
+
+	TestFalse(TEXT("Bound only to the requested action"), UInputConfig::IsDoubleBound(TestKeyA, TestActionName));
+	TestTrue(TEXT("Bound to another action"), UInputConfig::IsDoubleBound(TestKeyA, TestOtherActionName));
+	TestFalse(TEXT("Unbound key"), UInputConfig::IsDoubleBound(TestKeyB, TestOtherActionName));
+
+	//Ctrl+A conflicts with A and with Ctrl+Shift+A, but not with Shift+A
+	TestTrue(TEXT("Same chord"), UInputConfig::GetConflicts(TestKeyA, true, false, false, false).Contains(TestActionName));
+	TestTrue(TEXT("Fewer modifiers"), UInputConfig::GetConflicts(TestKeyA, false, false, false, false).Contains(TestActionName));
+	TestTrue(TEXT("More modifiers"), UInputConfig::GetConflicts(TestKeyA, true, true, false, false).Contains(TestActionName));
+	TestFalse(TEXT("Different modifiers"), UInputConfig::GetConflicts(TestKeyA, false, true, false, false).Contains(TestActionName));
+
+	//an axis on the key conflicts whatever the modifiers
+	UInputConfig::AddAxisMapping(TestAxisName, TestKeyA, 1.f);
+	TestTrue(TEXT("Axis conflicts"), UInputConfig::GetConflicts(TestKeyA, false, true, false, false).Contains(TestAxisName));
+	TestTrue(TEXT("Axis makes the key double bound"), UInputConfig::IsDoubleBound(TestKeyA, TestActionName));
+
+	UInputConfig::DiscardChanges();
+	TestFalse(TEXT("Discarded bindings no longer conflict"), UInputConfig::IsDoubleBound(TestKeyA, TestOtherActionName));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInputConfigSaveAndDiscardTest, "ExtraConfig.InputConfig.SaveAndDiscard", EAutomationTestFlags::ATF_Editor | EAutomationTestFlags::ATF_Game)
+
+bool FInputConfigSaveAndDiscardTest::RunTest(const FString& Parameters)
+{
+	FScopedMemoryConfigBackend backend;
+
+	//DiscardChanges reloads from the config, so whatever survives it was saved
+	UInputConfig::AddActionMapping(TestActionName, TestKeyA, false, false, false, false);
+	UInputConfig::AddAxisMapping(TestAxisName, TestKeyA, -1.f);
+	UInputConfig::AddAnalogConfig(TestKeyA, true, 0.2f, 2.f, 1.f);
+	UInputConfig::SaveChanges();
+	UInputConfig::DiscardChanges();
+
+	TestEqual(TEXT("Saves reaching the backend"), backend.Memory.InputSaves, 1);
+	TestFalse(TEXT("Real input settings untouched"), GetDefault<UInputSettings>()->ActionMappings.ContainsByPredicate([](const FInputActionKeyMapping& mapping)
+	{
+		return mapping.ActionName == TestActionName;
+	}));
+
+	TestTrue(TEXT("Saved action kept"), HasActionMap(TestActionName, TestKeyA, false, false, false, false));
+	TestTrue(TEXT("Saved axis kept"), HasAxisMap(TestAxisName, TestKeyA, -1.f));
+	TestTrue(TEXT("Saved analog config kept"), UInputConfig::GetConfigForAnalog(TestKeyA).Invert);
+
+	UInputConfig::ModifyActionMapping(TestActionName, TestKeyA, true, false, false, false);
+	UInputConfig::ModifyAxisMapping(TestAxisName, TestKeyA, 1.f);
+	UInputConfig::ModifyAnalogConfig(TestKeyA, false, 0.2f, 2.f, 1.f);
+	UInputConfig::AddActionMapping(TestOtherActionName, TestKeyB, false, false, false, false);
+	UInputConfig::DiscardChanges();
+
+	TestTrue(TEXT("Unsaved action edit dropped"), HasActionMap(TestActionName, TestKeyA, false, false, false, false));
+	TestTrue(TEXT("Unsaved axis edit dropped"), HasAxisMap(TestAxisName, TestKeyA, -1.f));
+	TestTrue(TEXT("Unsaved analog edit dropped"), UInputConfig::GetConfigForAnalog(TestKeyA).Invert);
+	TestFalse(TEXT("Unsaved add dropped"), UInputConfig::GetActionNames().Contains(TestOtherActionName));
+
+	//removals are saved the same way
+	UInputConfig::RemoveActionMapping(TestActionName, TestKeyA, false, false, false, false);
+	UInputConfig::RemoveAxisMapping(TestAxisName, TestKeyA, -1.f);
+	UInputConfig::RemoveAnalogConfig(TestKeyA);
+	UInputConfig::SaveChanges();
+	UInputConfig::DiscardChanges();
+
+	TestFalse(TEXT("Saved action removal kept"), UInputConfig::GetActionNames().Contains(TestActionName));
+	TestFalse(TEXT("Saved axis removal kept"), UInputConfig::GetAxisNames().Contains(TestAxisName));
+	TestFalse(TEXT("Saved analog removal kept"), UInputConfig::GetAnalogKeys().Contains(TestKeyA));
+
+	return true;
+}
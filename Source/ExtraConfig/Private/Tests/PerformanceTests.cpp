@@ -0,0 +1,129 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ExtraConfigPrivatePCH.h"
+#include "InputConfig.h"
+#include "InputBindingIndex.h"
+#include "ConfigBenchmarks.h"
+#include "ConfigTestBackend.h"
+#include "AutomationTest.h"
+
+//Budgets are the ExtraConfig.BenchCore baselines saved on this machine plus this margin, which
+//leaves room for a busy machine; a scan over the mappings at 10k still blows through them
+static const double PerfBudgetMargin = 1.0;
+
+static const int32 PerfKeyCount = 200;
+
+template<typename FunctionType>
+static double MeasureNsPerCall(int32 iterations, FunctionType run)
+{
+	//one untimed call builds whatever index the path needs
+	run(0);
+
+	double start = FPlatformTime::Seconds();
+	for (int32 i = 0; i < iterations; i++)
+	{
+		run(i);
+	}
+	return (FPlatformTime::Seconds() - start) * 1e9 / iterations;
+}
+
+//Checks a timing against the baseline of the bench case measuring the same path, if one was saved
+static void TestBudget(FAutomationTestBase& test, const TMap<FString, double>& baselines, const FString& benchCase, const FString& what, double ns)
+{
+	const double* baseline = baselines.Find(benchCase);
+	if (!baseline || *baseline <= 0.0)
+	{
+		test.AddWarning(FString::Printf(TEXT("%s: no %s baseline, run ExtraConfig.BenchCore -save"), *what, *benchCase));
+		return;
+	}
+
+	double budgetNs = *baseline * (1.0 + PerfBudgetMargin);
+	test.TestTrue(FString::Printf(TEXT("%s: %.0f ns, budget %.0f from %s"), *what, ns, budgetNs, *benchCase), ns <= budgetNs);
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPerformanceBudgetsTest, "ExtraConfig.Performance.Budgets", EAutomationTestFlags::ATF_Editor | EAutomationTestFlags::ATF_Game)
+
+bool FPerformanceBudgetsTest::RunTest(const FString& Parameters)
+{
+	TMap<FString, double> baselines = FConfigBenchBaselines::Load();
+
+	TArray<FKey> keys;
+	for (int32 i = 0; i < PerfKeyCount; i++)
+	{
+		keys.Add(FKey(FName(*FString::Printf(TEXT("ExtraConfigPerfKey%d"), i))));
+	}
+
+	//the mappings below and every save go to the backend's copy of the input settings
+	FScopedMemoryConfigBackend backend;
+	UInputSettings* Settings = backend.Memory.GetInputSettings();
+
+	TArray<FInputActionKeyMapping> originalActions = Settings->ActionMappings;
+	TArray<FInputAxisKeyMapping> originalAxes = Settings->AxisMappings;
+
+	const int32 sizes[] = { 100, 1000, 10000 };
+	float sink = 0.f;
+
+	for (int32 size : sizes)
+	{
+		//straight into the settings: AddUnique per mapping would make the setup quadratic
+		Settings->ActionMappings = originalActions;
+		Settings->AxisMappings = originalAxes;
+
+		TArray<FName> actionNames;
+		for (int32 i = 0; i < size; i++)
+		{
+			FName name(*FString::Printf(TEXT("ExtraConfigPerf%d"), i));
+			if (i % 4 == 0)
+			{
+				Settings->AxisMappings.Add(FInputAxisKeyMapping(name, keys[i % PerfKeyCount], 1.f));
+			}
+			else
+			{
+				Settings->ActionMappings.Add(FInputActionKeyMapping(name, keys[i % PerfKeyCount], true, (i & 2) != 0));
+				actionNames.Add(name);
+			}
+		}
+
+		FInputBindingIndex::MarkSettingsChanged();
+
+		double graphicsNs = MeasureNsPerCall(100000, [&](int32 i)
+		{
+			sink += (int32)UGraphicsConfig::GetGraphicsSettings().Shadows;
+		});
+
+		double doubleBoundNs = MeasureNsPerCall(10000, [&](int32 i)
+		{
+			sink += UInputConfig::IsDoubleBound(keys[i % PerfKeyCount], actionNames[0]) ? 1.f : 0.f;
+		});
+
+		double keysForActionNs = MeasureNsPerCall(10000, [&](int32 i)
+		{
+			sink += UInputConfig::GetKeysForAction(actionNames[i % actionNames.Num()]).Num();
+		});
+
+		//each save commits one edited name, like a player rebinding a key in the menu
+		FName savedName = actionNames[0];
+		FKey savedKey = keys[1];
+		double saveNs = MeasureNsPerCall(5, [&](int32 i)
+		{
+			UInputConfig::ModifyActionMapping(savedName, savedKey, (i & 1) != 0, true, false, false);
+			UInputConfig::SaveChanges();
+		});
+
+		AddLogItem(FString::Printf(TEXT("%d mappings: GetGraphicsSettings %.0f ns, IsDoubleBound %.0f ns, GetKeysForAction %.0f ns, SaveChanges %.2f ms"),
+			size, graphicsNs, doubleBoundNs, keysForActionNs, saveNs / 1e6));
+
+		FString suffix = FString::Printf(TEXT("_%d"), size);
+
+		TestBudget(*this, baselines, TEXT("get_cached"), FString::Printf(TEXT("GetGraphicsSettings at %d mappings"), size), graphicsNs);
+		TestBudget(*this, baselines, TEXT("double_bound") + suffix, FString::Printf(TEXT("IsDoubleBound at %d mappings"), size), doubleBoundNs);
+		TestBudget(*this, baselines, TEXT("keys_for_action") + suffix, FString::Printf(TEXT("GetKeysForAction at %d mappings"), size), keysForActionNs);
+		TestBudget(*this, baselines, TEXT("save_changes") + suffix, FString::Printf(TEXT("SaveChanges at %d mappings"), size), saveNs);
+	}
+
+	TestTrue(TEXT("Queries saw the test bindings"), sink > 0.f);
+	//the untimed call plus five timed ones per size, none of them reaching Input.ini
+	TestEqual(TEXT("Saves reaching the backend"), backend.Memory.InputSaves, 6 * (int32)ARRAY_COUNT(sizes));
+
+	return true;
+}
@@ -0,0 +1,149 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ExtraConfigPrivatePCH.h"
+#include "QualityGovernor.h"
+#include "ConfigTestBackend.h"
+#include "AutomationTest.h"
+
+struct FGovernorDecision
+{
+	FName CVarName;
+	int32 OldValue;
+	int32 NewValue;
+	//frames fed when it was made
+	int32 Frame;
+};
+
+//Drives a governor from a synthetic frame time through its injected source, recording every decision
+class FGovernorHarness
+{
+public:
+
+	FGovernorHarness(FMemoryConfigBackend& memory) : Memory(memory), FrameMs(0.f), Frames(0)
+	{
+		Governor = UQualityGovernor::CreateQualityGovernor(60.f);
+		Governor->WindowSize = 10;
+		Governor->MinDwellSeconds = 0.9f;
+		Governor->SetFrameTimeSource([this]() { return FFrameTimeSample(FrameMs, FrameMs * 0.5f, FrameMs); });
+		Governor->OnDecisionNative.AddLambda([this](FName cvarName, int32 oldValue, int32 newValue, float averageMs)
+		{
+			FGovernorDecision decision = { cvarName, oldValue, newValue, Frames };
+			Decisions.Add(decision);
+		});
+	}
+
+	void Run(float frameMs, int32 frames)
+	{
+		FrameMs = frameMs;
+		for (int32 i = 0; i < frames; i++)
+		{
+			Frames++;
+			Governor->Tick(frameMs / 1000.f);
+		}
+	}
+
+	int32 GetCVar(const TCHAR* name) const
+	{
+		return Memory.CVars.FindRef(name);
+	}
+
+	FMemoryConfigBackend& Memory;
+	UQualityGovernor* Governor;
+	float FrameMs;
+	int32 Frames;
+	TArray<FGovernorDecision> Decisions;
+};
+
+static const TCHAR* LadderCVars[] =
+{
+	TEXT("r.ScreenPercentage"),
+	TEXT("r.AmbientOcclusionLevels"),
+	TEXT("r.SSR.Quality"),
+	TEXT("sg.ShadowQuality"),
+};
+
+static int32 GetLadderIndex(FName cvarName)
+{
+	for (int32 i = 0; i < ARRAY_COUNT(LadderCVars); i++)
+	{
+		if (cvarName == FName(LadderCVars[i]))
+		{
+			return i;
+		}
+	}
+
+	return INDEX_NONE;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FQualityGovernorDecisionsTest, "ExtraConfig.QualityGovernor.Decisions", EAutomationTestFlags::ATF_Editor | EAutomationTestFlags::ATF_Game)
+
+bool FQualityGovernorDecisionsTest::RunTest(const FString& Parameters)
+{
+	//the governor only reaches the live cvars through the backend
+	FScopedMemoryConfigBackend backend;
+	backend.Memory.CVars.Add(TEXT("r.ScreenPercentage"), 100);
+	backend.Memory.CVars.Add(TEXT("r.AmbientOcclusionLevels"), 3);
+	backend.Memory.CVars.Add(TEXT("r.SSR.Quality"), 3);
+	backend.Memory.CVars.Add(TEXT("sg.ShadowQuality"), 3);
+
+	FGovernorHarness harness(backend.Memory);
+	harness.Governor->Enable();
+
+	//25 ms frames miss the 16.7 ms target, but nothing moves until the dwell time has been sampled
+	harness.Run(25.f, 30);
+	TestEqual(TEXT("Decisions inside the first dwell"), harness.Decisions.Num(), 0);
+
+	harness.Run(25.f, 10);
+	TestEqual(TEXT("Decisions once the window average misses the target"), harness.Decisions.Num(), 1);
+	TestEqual(TEXT("Screen percentage stepped down"), harness.GetCVar(TEXT("r.ScreenPercentage")), 90);
+
+	//keep missing until the ladder runs out: screen percentage, then SSAO, SSR and shadows
+	harness.Run(25.f, 1000);
+	TestEqual(TEXT("Screen percentage floor"), harness.GetCVar(TEXT("r.ScreenPercentage")), 70);
+	TestEqual(TEXT("SSAO floor"), harness.GetCVar(TEXT("r.AmbientOcclusionLevels")), 0);
+	TestEqual(TEXT("SSR floor"), harness.GetCVar(TEXT("r.SSR.Quality")), 0);
+	TestEqual(TEXT("Shadow floor"), harness.GetCVar(TEXT("sg.ShadowQuality")), 1);
+
+	int32 lastIndex = 0;
+	bool bInOrder = true;
+	for (const FGovernorDecision& decision : harness.Decisions)
+	{
+		int32 index = GetLadderIndex(decision.CVarName);
+		bInOrder &= index >= lastIndex && decision.NewValue < decision.OldValue;
+		lastIndex = FMath::Max(lastIndex, index);
+	}
+	TestTrue(TEXT("Stepped down in ladder order"), bInOrder);
+	TestEqual(TEXT("Last step down"), GetLadderIndex(harness.Decisions.Last().CVarName), 3);
+
+	//every decision reached the backend and the delegate, with the values it applied
+	int32 downSteps = harness.Decisions.Num();
+	TestEqual(TEXT("Steps down"), downSteps, 3 + 3 + 3 + 2);
+	TestEqual(TEXT("Cvar sets per decision"), backend.Memory.CVarSets, downSteps);
+
+	//15 ms is inside the hysteresis band: not over the target plus DownMargin, not under it minus UpMargin
+	harness.Run(15.f, 1000);
+	TestEqual(TEXT("Decisions inside the hysteresis band"), harness.Decisions.Num(), downSteps);
+
+	//headroom walks back up in reverse, one step per dwell
+	harness.Run(10.f, 2000);
+	TestEqual(TEXT("Screen percentage restored"), harness.GetCVar(TEXT("r.ScreenPercentage")), 100);
+	TestEqual(TEXT("Shadows restored"), harness.GetCVar(TEXT("sg.ShadowQuality")), 3);
+	TestEqual(TEXT("Steps up"), harness.Decisions.Num() - downSteps, downSteps);
+	TestEqual(TEXT("First step up"), GetLadderIndex(harness.Decisions[downSteps].CVarName), 3);
+
+	int32 dwellFrames = FMath::CeilToInt(harness.Governor->MinDwellSeconds * 1000.f / 10.f);
+	for (int32 i = downSteps + 1; i < harness.Decisions.Num(); i++)
+	{
+		const FGovernorDecision& previous = harness.Decisions[i - 1];
+		const FGovernorDecision& decision = harness.Decisions[i];
+
+		TestTrue(FString::Printf(TEXT("Step up %d waited out the dwell"), i - downSteps), decision.Frame - previous.Frame >= dwellFrames);
+		TestTrue(FString::Printf(TEXT("Step up %d raised %s"), i - downSteps, *decision.CVarName.ToString()), decision.NewValue > decision.OldValue);
+	}
+
+	TestEqual(TEXT("Cvar sets per decision after stepping up"), backend.Memory.CVarSets, harness.Decisions.Num());
+
+	harness.Governor->Disable();
+
+	return true;
+}
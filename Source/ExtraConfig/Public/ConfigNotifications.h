@@ -0,0 +1,68 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "Engine.h"
+#include "GraphicsConfig.h"
+#include "ConfigNotifications.generated.h"
+
+//Non-graphics config that can change; used as bit indices in ChangedConfig
+UENUM(BlueprintType)
+enum class EConfigChange : uint8
+{
+	Resolution,
+	ScreenMode,
+	RefreshRate,	//not broadcast: the refresh rate is a stored preference the RHI picks from
+	GraphicsPreset,
+	ActionMappings,
+	AxisMappings,
+	AnalogConfig,
+	MAX				UMETA(Hidden)
+};
+
+//ChangedConfig holds 1 << EConfigChange bits, ChangedGraphicsSettings 1 << EGraphicsSetting bits
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnConfigChanged, int32, ChangedConfig, int32, ChangedGraphicsSettings);
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnConfigChangedNative, int32, int32);
+
+/**
+ * Broadcasts config changes made through UGraphicsConfig and UInputConfig so UI doesn't have to
+ * poll. Changes are accumulated and broadcast once on the next engine tick, so a preset switch or
+ * a batch of rebinds arrives as a single notification. Input edits are reported when
+ * UInputConfig::SaveChanges commits them, not while they are being made.
+ */
+UCLASS(BlueprintType)
+class UConfigNotifications : public UObject
+{
+	GENERATED_UCLASS_BODY()
+
+public:
+
+	UFUNCTION(BlueprintPure, Category = "Config|Notifications")
+	static UConfigNotifications* GetConfigNotifications();
+
+	UPROPERTY(BlueprintAssignable, Category = "Config|Notifications")
+	FOnConfigChanged OnConfigChanged;
+
+	//C++ listeners; fired before the Blueprint delegate
+	static FOnConfigChangedNative OnConfigChangedNative;
+
+	UFUNCTION(BlueprintPure, Category = "Config|Notifications")
+	static bool HasConfigChange(int32 changedConfig, EConfigChange change);
+
+	UFUNCTION(BlueprintPure, Category = "Config|Notifications")
+	static bool HasGraphicsSettingChange(int32 changedGraphicsSettings, EGraphicsSetting setting);
+
+	//Records changes for the next broadcast
+	static void MarkChanged(int32 changedConfig, int32 changedGraphicsSettings);
+
+	static void MarkChanged(EConfigChange change);
+
+	//Broadcasts anything pending right away instead of waiting for the tick
+	static void FlushNotifications();
+
+	static void Shutdown();
+
+private:
+
+	static bool TickNotifications(float deltaTime);
+};
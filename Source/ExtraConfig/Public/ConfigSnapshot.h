@@ -0,0 +1,113 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "Engine.h"
+#include "GraphicsConfig.h"
+#include "GameFramework/InputSettings.h"
+
+class FConfigSnapshotRef;
+
+/**
+ * Immutable copy of the graphics, display and input config that any thread may read. The game
+ * thread builds a new snapshot on every config commit and publishes it with a single pointer
+ * swap; readers take a reference without locking and keep a consistent view for as long as they
+ * hold it. Publishing never waits for readers: a swapped-out snapshot is released once no reader
+ * can still be taking a reference to it, checked on later publishes and ticks.
+ */
+class FConfigSnapshot
+{
+public:
+
+	FGraphicsSettings Graphics;
+	FIntPoint Resolution;
+	EScreenMode ScreenMode;
+
+	TArray<FInputActionKeyMapping> ActionMappings;
+	TArray<FInputAxisKeyMapping> AxisMappings;
+	TArray<FInputAxisConfigEntry> AxisConfig;
+
+	//increases by one with every publish
+	int32 Generation;
+
+	/** The latest published snapshot. Safe on any thread; invalid until the first publish. */
+	static FConfigSnapshotRef Acquire();
+
+	/** Builds a snapshot from the current config and publishes it. Game thread only. */
+	static void PublishCurrent();
+
+	/** Publishes a snapshot, taking ownership. Game thread only. */
+	static void Publish(FConfigSnapshot* snapshot);
+
+	/** Drops the published snapshot; outstanding references stay valid. */
+	static void Shutdown();
+
+	/** Snapshots not yet freed, published, retired or referenced. For leak checks. */
+	static int32 GetLiveCount();
+
+	FConfigSnapshot();
+
+private:
+
+	friend class FConfigSnapshotRef;
+
+	void AddRef() const;
+	void Release() const;
+
+	static bool Reclaim(float deltaTime);
+	static void ReleaseAll(TArray<FConfigSnapshot*>& snapshots);
+
+	mutable FThreadSafeCounter RefCount;
+};
+
+/** Counted reference to a published snapshot. */
+class FConfigSnapshotRef
+{
+public:
+
+	FConfigSnapshotRef() : Snapshot(nullptr) {}
+
+	FConfigSnapshotRef(const FConfigSnapshotRef& other) : Snapshot(other.Snapshot)
+	{
+		if (Snapshot)
+		{
+			Snapshot->AddRef();
+		}
+	}
+
+	FConfigSnapshotRef& operator=(const FConfigSnapshotRef& other)
+	{
+		if (other.Snapshot)
+		{
+			other.Snapshot->AddRef();
+		}
+		if (Snapshot)
+		{
+			Snapshot->Release();
+		}
+		Snapshot = other.Snapshot;
+		return *this;
+	}
+
+	~FConfigSnapshotRef()
+	{
+		if (Snapshot)
+		{
+			Snapshot->Release();
+		}
+	}
+
+	bool IsValid() const { return Snapshot != nullptr; }
+
+	const FConfigSnapshot* operator->() const { return Snapshot; }
+	const FConfigSnapshot& operator*() const { return *Snapshot; }
+
+private:
+
+	friend class FConfigSnapshot;
+
+	//adopts a reference the caller already took
+	explicit FConfigSnapshotRef(const FConfigSnapshot* snapshot) : Snapshot(snapshot) {}
+
+	const FConfigSnapshot* Snapshot;
+};
@@ -0,0 +1,26 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "Engine.h"
+#include "Commandlets/Commandlet.h"
+#include "ExtraConfigLintCommandlet.generated.h"
+
+/**
+ * Lints every .ini under a directory tree, e.g. saved configs collected from crash reports, in
+ * parallel on all cores, and logs a summary with the throughput in files per second.
+ *
+ * -run=ExtraConfigLint -dir=<path> [-fix] [-report=<file>] [-generate=<count>] [-singlethread]
+ *
+ * -fix rewrites files that have problems; without it nothing is written. -report writes a CSV
+ * line per file with problems. -generate first writes a synthetic corpus of that many files.
+ */
+UCLASS()
+class UExtraConfigLintCommandlet : public UCommandlet
+{
+	GENERATED_UCLASS_BODY()
+
+public:
+
+	virtual int32 Main(const FString& params) override;
+};
@@ -24,6 +24,37 @@ enum class EQuality : uint8
 	Ultra		UMETA(DisplayName = "Ultra")
 };
 
+//When a changed graphics setting takes effect in the running game
+UENUM(BlueprintType)
+enum class EGraphicsApply : uint8
+{
+	Instant		UMETA(DisplayName = "Instant"),
+	NextLevel	UMETA(DisplayName = "Next Level Load"),
+	Restart		UMETA(DisplayName = "Restart Required")
+};
+
+//One entry per FGraphicsSettings field; DiffGraphicsSettings uses these as bit indices
+UENUM(BlueprintType)
+enum class EGraphicsSetting : uint8
+{
+	VSync,
+	Anisotropic,
+	Antialiasing,
+	Shadows,
+	SSAO,
+	Reflections,
+	MotionBlur,
+	LensFlare,
+	Bloom,
+	SimpleLighting,
+	ViewDistance,
+	Textures,
+	Effects,
+	PostProcess,
+	Foliage,
+	MAX			UMETA(Hidden)
+};
+
 USTRUCT(BlueprintType)
 struct FInt2D
 {
@@ -76,7 +107,52 @@ struct FGraphicsSettings
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Graphics|Structs")
 	bool SimpleLighting;
-		
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Graphics|Structs")
+	EQuality ViewDistance;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Graphics|Structs")
+	EQuality Textures;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Graphics|Structs")
+	EQuality Effects;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Graphics|Structs")
+	EQuality PostProcess;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Graphics|Structs")
+	EQuality Foliage;
+
+	FGraphicsSettings() :
+		VSync(false), Anisotropic(0), Antialiasing(EQuality::Off), Shadows(EQuality::Off), SSAO(EQuality::Off),
+		Reflections(EQuality::Off), MotionBlur(EQuality::Off), LensFlare(EQuality::Off), Bloom(EQuality::Off),
+		SimpleLighting(false), ViewDistance(EQuality::Off), Textures(EQuality::Off), Effects(EQuality::Off),
+		PostProcess(EQuality::Off), Foliage(EQuality::Off)
+	{}
+};
+
+USTRUCT(BlueprintType)
+struct FRecommendedSettings
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Graphics|Structs")
+	EQuality Preset;
+
+	//The preset's settings with any per-setting overrides applied
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Graphics|Structs")
+	FGraphicsSettings Settings;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Graphics|Structs")
+	float CPUScore;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Graphics|Structs")
+	int32 Cores;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Graphics|Structs")
+	int32 MemoryMB;
+
+	FRecommendedSettings() : Preset(EQuality::Medium), CPUScore(0.f), Cores(0), MemoryMB(0) {}
 };
 
 /**
@@ -92,15 +168,37 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Graphics")
 	static void SetResolution(int32 width, int32 height);
 
+	//Validates against the display mode list, then applies resolution and window mode with at most one
+	//mode switch and one save. Does nothing when the request matches the current state.
+	//refreshRate 0 leaves it to the RHI; otherwise it is validated and stored, as the RHI picks the rate itself.
+	//SetResolution and SetScreenMode keep the stored rate while the new mode still offers it.
+	UFUNCTION(BlueprintCallable, Category = "Graphics")
+	static bool ApplyDisplayMode(int32 width, int32 height, EScreenMode mode, int32 refreshRate);
+
+	UFUNCTION(BlueprintPure, Category = "Graphics")
+	static int32 GetRefreshRate();
+
 	UFUNCTION(BlueprintPure, Category = "Graphics")
 	static FInt2D GetCurrentResolution();
 
 	UFUNCTION(BlueprintPure, Category = "Graphics")
 	static FInt2D GetDefaultResolution();
 
+	//Sorted by width then height, one entry per resolution. Enumerated once and cached until RefreshDisplayModes.
 	UFUNCTION(BlueprintPure, Category = "Graphics")
 	static TArray<FInt2D> GetValidResolutions();
 
+	UFUNCTION(BlueprintPure, Category = "Graphics")
+	static TArray<int32> GetRefreshRates(int32 width, int32 height);
+
+	//Largest valid resolution of the aspect ratio that fits inside maxWidth x maxHeight, or 0x0 if there is none
+	UFUNCTION(BlueprintPure, Category = "Graphics")
+	static FInt2D GetLargestResolution(int32 maxWidth, int32 maxHeight, int32 aspectX, int32 aspectY);
+
+	//Call when a display is connected, removed or changes mode outside the game
+	UFUNCTION(BlueprintCallable, Category = "Graphics")
+	static void RefreshDisplayModes();
+
 	UFUNCTION(BlueprintPure, Category = "Graphics")
 	static EScreenMode GetScreenMode();
 
@@ -113,9 +211,80 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Graphics")
 	static void SetGraphicsPreset(EQuality level);
 
+	//Async variants for menus. Display modes are enumerated on a worker thread, the mode switch runs on
+	//the game thread once they are known, and the nodes complete after the saved settings reach disk.
+	UFUNCTION(BlueprintCallable, Category = "Graphics", meta = (Latent, LatentInfo = "latentInfo", WorldContext = "worldContextObject"))
+	static void GetValidResolutionsAsync(UObject* worldContextObject, FLatentActionInfo latentInfo, TArray<FInt2D>& resolutions);
+
+	UFUNCTION(BlueprintCallable, Category = "Graphics", meta = (Latent, LatentInfo = "latentInfo", WorldContext = "worldContextObject"))
+	static void SetResolutionAsync(UObject* worldContextObject, FLatentActionInfo latentInfo, int32 width, int32 height, bool& success);
+
+	UFUNCTION(BlueprintCallable, Category = "Graphics", meta = (Latent, LatentInfo = "latentInfo", WorldContext = "worldContextObject"))
+	static void SetScreenModeAsync(UObject* worldContextObject, FLatentActionInfo latentInfo, EScreenMode mode, bool& success);
+
+	//C++ versions of the above; callbacks run on the game thread, immediately if nothing has to wait
+	static void RequestValidResolutions(TFunction<void(const TArray<FInt2D>&)> onComplete);
+	static void RequestResolution(int32 width, int32 height, TFunction<void(bool)> onComplete);
+	static void RequestScreenMode(EScreenMode mode, TFunction<void(bool)> onComplete);
+
+	//Runs a short CPU benchmark and surveys memory, cores and GPU. The result is cached in
+	//GameUserSettings.ini and reused until the hardware fingerprint changes, unless force is set.
+	UFUNCTION(BlueprintCallable, Category = "Graphics")
+	static FRecommendedSettings DetectRecommendedPreset(bool force);
+
+	//Detects and applies the recommended preset when no preset was ever chosen and detection never
+	//ran, i.e. on the first launch of a new install. The module calls this on the first engine tick.
+	static bool ApplyRecommendedPresetOnFirstLaunch();
+
+	//Served from an in-memory cache that the setters keep current
 	UFUNCTION(BlueprintPure, Category = "Graphics")
 	static FGraphicsSettings GetGraphicsSettings();
 
+	//Increases every time a graphics setting changes, so callers can skip work when it hasn't moved
+	UFUNCTION(BlueprintPure, Category = "Graphics")
+	static int32 GetGraphicsSettingsGeneration();
+
+	//Reloads of the engine ini are picked up when the engine reapplies its console variables; call this
+	//after changing the ini some other way
+	UFUNCTION(BlueprintCallable, Category = "Graphics")
+	static void InvalidateGraphicsSettings();
+
+	//Uncached read straight from the config backend
+	static FGraphicsSettings ReadGraphicsSettingsFromConfig();
+
+	//Fills the cache from values known to match the ini, e.g. the startup settings cache
+	static void PrimeGraphicsSettings(const FGraphicsSettings& settings);
+
+	//Generic access by setting; values are clamped to the range of the backing console variable
+	UFUNCTION(BlueprintPure, Category = "Graphics")
+	static int32 GetGraphicsSetting(EGraphicsSetting setting);
+
+	UFUNCTION(BlueprintCallable, Category = "Graphics")
+	static void SetGraphicsSetting(EGraphicsSetting setting, int32 value);
+
+	UFUNCTION(BlueprintPure, Category = "Graphics")
+	static EGraphicsApply GetGraphicsSettingApply(EGraphicsSetting setting);
+
+	//Bitmask of (1 << EGraphicsSetting) for every field that differs
+	UFUNCTION(BlueprintPure, Category = "Graphics")
+	static int32 DiffGraphicsSettings(const FGraphicsSettings& a, const FGraphicsSettings& b);
+
+	//Batching: setters called between Begin and Commit only write to disk once, on the outermost commit.
+	//Commit returns the number of config files it flushed.
+	UFUNCTION(BlueprintCallable, Category = "Graphics")
+	static void BeginGraphicsChanges();
+
+	UFUNCTION(BlueprintCallable, Category = "Graphics")
+	static int32 CommitGraphicsChanges();
+
+	UFUNCTION(BlueprintCallable, Category = "Graphics")
+	static int32 ApplyGraphicsSettings(const FGraphicsSettings& settings);
+
+	//Committed changes are applied to the live console variables. Returns the most disruptive
+	//class still outstanding: NextLevel until the next map load, Restart if a restart-only setting differs.
+	UFUNCTION(BlueprintPure, Category = "Graphics")
+	static EGraphicsApply GetPendingGraphicsApply();
+
 	UFUNCTION(BlueprintCallable, Category = "Graphics")
 	static void ToggleVSync(bool vSync);
 
@@ -145,4 +314,19 @@ public:
 
 	UFUNCTION(BlueprintCallable, Category = "Graphics")
 	static void ToggleSimpleLighting(bool simple);
+
+	UFUNCTION(BlueprintCallable, Category = "Graphics")
+	static void SetViewDistanceQuality(EQuality viewDistance);
+
+	UFUNCTION(BlueprintCallable, Category = "Graphics")
+	static void SetTextureQuality(EQuality textures);
+
+	UFUNCTION(BlueprintCallable, Category = "Graphics")
+	static void SetEffectsQuality(EQuality effects);
+
+	UFUNCTION(BlueprintCallable, Category = "Graphics")
+	static void SetPostProcessQuality(EQuality postProcess);
+
+	UFUNCTION(BlueprintCallable, Category = "Graphics")
+	static void SetFoliageQuality(EQuality foliage);
 };
@@ -125,6 +125,7 @@ public:
 	static TArray<FAxisMap> GetKeysForAxis(FName axisName);
 
 	//Axis Config
+	//deadZone is clamped to [0, 0.99] and an exponent <= 0 becomes 1, as both would divide by zero
 	UFUNCTION(BlueprintCallable, Category = "Keybinding|Config")
 	static bool AddAnalogConfig(FKey axisKey, bool invert, float deadZone, float sensitivity, float exponent);
 
@@ -140,13 +141,38 @@ public:
 	UFUNCTION(BlueprintPure, Category = "Keybinding|Config")
 	static FAnalogConfig GetConfigForAnalog(FKey key);
 
+	//Raw axis value after the key's dead zone, exponent, sensitivity and invert
+	UFUNCTION(BlueprintPure, Category = "Keybinding|Config")
+	static float EvaluateAnalog(FKey key, float value);
+
+	//Batch variant for C++ callers, e.g. gyro or replay processing. in and out may alias.
+	static void EvaluateAnalogBatch(FKey key, const float* in, float* out, int32 count);
+
+	//Allocation-free C++ variants of the queries above. The arrays belong to an internal index
+	//and stay valid until the next mapping edit, SaveChanges or DiscardChanges.
+	static const TArray<FName>& ViewActionNames();
+	static const TArray<FActionMap>& ViewKeysForAction(FName actionName);
+	static const TArray<FName>& ViewAxisNames();
+	static const TArray<FAxisMap>& ViewKeysForAxis(FName axisName);
+	static const TArray<FKey>& ViewAnalogKeys();
+
 	//Utility
 	UFUNCTION(BlueprintCallable, Category = "Keybinding|Utility")
 	static void SaveChanges();
 
+	//Completes once the input ini has reached disk; the file is written on a worker thread
+	UFUNCTION(BlueprintCallable, Category = "Keybinding|Utility", meta = (Latent, LatentInfo = "latentInfo", WorldContext = "worldContextObject"))
+	static void SaveChangesAsync(UObject* worldContextObject, FLatentActionInfo latentInfo);
+
+	static void RequestSaveChanges(TFunction<void()> onComplete);
+
 	UFUNCTION(BlueprintCallable, Category = "Keybinding|Utility")
 	static void DiscardChanges();
 
 	UFUNCTION(BlueprintPure, Category = "Keybinding|Utility")
 	static bool IsDoubleBound(FKey key, FName requestedBind);
+
+	//Actions and axes that would fire together with the key and modifiers
+	UFUNCTION(BlueprintPure, Category = "Keybinding|Utility")
+	static TArray<FName> GetConflicts(FKey key, bool ctrl, bool shift, bool alt, bool cmd);
 };
@@ -0,0 +1,50 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "Engine.h"
+#include "InputConfig.h"
+#include "InputProfiles.generated.h"
+
+/**
+ * Bindings for a single local player, for split-screen. Edits apply straight to that player's
+ * UPlayerInput and never touch the UInputSettings defaults used by UInputConfig.
+ */
+UCLASS()
+class UInputProfiles : public UBlueprintFunctionLibrary
+{
+	GENERATED_UCLASS_BODY()
+public:
+
+	UFUNCTION(BlueprintCallable, Category = "Keybinding|Profile")
+	static bool AddPlayerActionMapping(APlayerController* player, FName actionName, FKey newKey, bool ctrl, bool shift, bool alt, bool cmd);
+
+	UFUNCTION(BlueprintCallable, Category = "Keybinding|Profile")
+	static bool RemovePlayerActionMapping(APlayerController* player, FName actionName, FKey oldKey, bool ctrl, bool shift, bool alt, bool cmd);
+
+	UFUNCTION(BlueprintPure, Category = "Keybinding|Profile")
+	static TArray<FActionMap> GetPlayerKeysForAction(APlayerController* player, FName actionName);
+
+	UFUNCTION(BlueprintCallable, Category = "Keybinding|Profile")
+	static bool AddPlayerAxisMapping(APlayerController* player, FName axisName, FKey newKey, float scale);
+
+	UFUNCTION(BlueprintCallable, Category = "Keybinding|Profile")
+	static bool RemovePlayerAxisMapping(APlayerController* player, FName axisName, FKey oldKey, float scale);
+
+	UFUNCTION(BlueprintPure, Category = "Keybinding|Profile")
+	static TArray<FAxisMap> GetPlayerKeysForAxis(APlayerController* player, FName axisName);
+
+	UFUNCTION(BlueprintPure, Category = "Keybinding|Profile")
+	static bool HasCustomProfile(APlayerController* player);
+
+	//Drops the player's own bindings and goes back to the shared defaults
+	UFUNCTION(BlueprintCallable, Category = "Keybinding|Profile")
+	static void ResetPlayerProfile(APlayerController* player);
+
+	//Profiles are stored in GameUserSettings.ini per controller id
+	UFUNCTION(BlueprintCallable, Category = "Keybinding|Profile")
+	static void SavePlayerProfile(APlayerController* player);
+
+	UFUNCTION(BlueprintCallable, Category = "Keybinding|Profile")
+	static bool LoadPlayerProfile(APlayerController* player);
+};
@@ -0,0 +1,125 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "Engine.h"
+#include "Tickable.h"
+#include "QualityGovernor.generated.h"
+
+USTRUCT(BlueprintType)
+struct FFrameTimeSample
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Graphics|Governor")
+	float FrameMs;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Graphics|Governor")
+	float GameThreadMs;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Graphics|Governor")
+	float RenderThreadMs;
+
+	FFrameTimeSample(float frameMs, float gameThreadMs, float renderThreadMs) :
+		FrameMs(frameMs), GameThreadMs(gameThreadMs), RenderThreadMs(renderThreadMs)
+	{}
+
+	FFrameTimeSample() : FrameMs(0.f), GameThreadMs(0.f), RenderThreadMs(0.f) {}
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_FourParams(FOnQualityGovernorDecision, FName, CVarName, int32, OldValue, int32, NewValue, float, AverageFrameMs);
+DECLARE_MULTICAST_DELEGATE_FourParams(FOnQualityGovernorDecisionNative, FName, int32, int32, float);
+
+/**
+ * Opt-in governor that steps individual settings down (screen percentage first, then SSAO,
+ * SSR and shadows) when the averaged frame time misses the target, and back up towards the
+ * player's own values when there is headroom. Changes are applied to the live console variables,
+ * through the config backend, and are never written to the ini. Settings the player changes through UGraphicsConfig while
+ * the governor runs become the new ceiling for that setting.
+ *
+ * An enabled governor keeps itself alive; hold a reference to keep a disabled one around.
+ */
+UCLASS(BlueprintType)
+class UQualityGovernor : public UObject, public FTickableGameObject
+{
+	GENERATED_UCLASS_BODY()
+
+public:
+
+	UFUNCTION(BlueprintCallable, Category = "Graphics|Governor")
+	static UQualityGovernor* CreateQualityGovernor(float targetFPS);
+
+	//Captures the current values as the ceiling the governor may restore to
+	UFUNCTION(BlueprintCallable, Category = "Graphics|Governor")
+	void Enable();
+
+	//Restores every setting the governor lowered
+	UFUNCTION(BlueprintCallable, Category = "Graphics|Governor")
+	void Disable();
+
+	UFUNCTION(BlueprintPure, Category = "Graphics|Governor")
+	bool IsEnabled() const { return bEnabled; }
+
+	//Feeds one frame. Tick does this from the frame time source; call directly to drive the governor by hand.
+	UFUNCTION(BlueprintCallable, Category = "Graphics|Governor")
+	void AddSample(const FFrameTimeSample& sample);
+
+	//Replaces the engine frame timings, e.g. with recorded or synthetic data when running headless
+	void SetFrameTimeSource(TFunction<FFrameTimeSample()> source);
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Graphics|Governor")
+	float TargetFPS;
+
+	//Frames averaged per decision; the window restarts after every change
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Graphics|Governor")
+	int32 WindowSize;
+
+	//Step down when the average is this fraction over the target frame time
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Graphics|Governor")
+	float DownMargin;
+
+	//Step up only when the average is this fraction under the target frame time
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Graphics|Governor")
+	float UpMargin;
+
+	//Sampled time that must pass after a step before the next one, so a coarse step such as
+	//10% screen percentage can't flip back and forth every window
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Graphics|Governor")
+	float MinDwellSeconds;
+
+	UPROPERTY(BlueprintAssignable, Category = "Graphics|Governor")
+	FOnQualityGovernorDecision OnDecision;
+
+	//C++ listeners; fired before the Blueprint delegate
+	FOnQualityGovernorDecisionNative OnDecisionNative;
+
+	//FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+
+	virtual void BeginDestroy() override;
+
+private:
+
+	bool StepDown(float averageMs);
+	bool StepUp(float averageMs);
+	void ApplyStep(int32 stepIndex, int32 newValue, float averageMs);
+
+	void OnConfigChanged(int32 changedConfig, int32 changedGraphicsSettings);
+
+	bool bEnabled;
+
+	//sum of the frame times fed since the last step
+	float SecondsSinceStep;
+
+	FDelegateHandle ConfigChangedHandle;
+
+	TFunction<FFrameTimeSample()> FrameTimeSource;
+
+	TArray<FFrameTimeSample> Window;
+
+	//Values captured by Enable and current values, one per ladder step
+	TArray<int32> Baseline;
+	TArray<int32> Current;
+};
@@ -0,0 +1,39 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "Engine.h"
+#include "GraphicsConfig.h"
+#include "SettingsProfiles.generated.h"
+
+/**
+ * Named snapshots of graphics settings, display mode and input bindings, e.g. "Streaming",
+ * "Battery" and "Competitive". All profiles live together in one binary file under Saved.
+ * Switching applies only the fields that differ from the current config, in a single batch.
+ */
+UCLASS()
+class USettingsProfiles : public UBlueprintFunctionLibrary
+{
+	GENERATED_UCLASS_BODY()
+public:
+
+	//Captures the current config under the name, replacing any profile already called that
+	UFUNCTION(BlueprintCallable, Category = "Config|Profiles")
+	static void SaveSettingsProfile(FName profileName);
+
+	//Returns how many settings and bindings changed, or -1 if there is no such profile
+	UFUNCTION(BlueprintCallable, Category = "Config|Profiles")
+	static int32 ApplySettingsProfile(FName profileName);
+
+	UFUNCTION(BlueprintCallable, Category = "Config|Profiles")
+	static bool DeleteSettingsProfile(FName profileName);
+
+	UFUNCTION(BlueprintPure, Category = "Config|Profiles")
+	static TArray<FName> GetSettingsProfileNames();
+
+	//The profile last saved or applied, or None
+	UFUNCTION(BlueprintPure, Category = "Config|Profiles")
+	static FName GetActiveSettingsProfile();
+
+	static FString GetProfilesFilename();
+};